@@ -0,0 +1,216 @@
+#include <string>
+#include <fstream>
+#include "core/Logger.hpp"
+#include "core/AllocationTracker.hpp"
+#include "core/CVar.hpp"
+#include "core/Settings.hpp"
+#include "core/VulkanManager.hpp"
+#include "core/FrameStatistics.hpp"
+#include "core/GpuProfiler.hpp"
+#include "core/Window.hpp"
+#include "render/Mesh.hpp"
+#include "render/RenderQueue.hpp"
+#include "render/ShaderManager.hpp"
+#include "render/TextureRegistry.hpp"
+
+#define BENCHMARK_DEFAULT_FRAMES 1000
+#define BENCHMARK_WARM_UP_FRAMES 60
+#define BENCHMARK_LAYERS 16
+#define BENCHMARK_DEFAULT_OUTPUT "benchmark.json"
+
+std::vector<Mesh> layers = {};
+
+void BuildScene()
+{
+	for (uint32_t i = 0; i < BENCHMARK_LAYERS; i++)
+	{
+		float depth = (i + 1) / (float)(BENCHMARK_LAYERS + 1);
+
+		std::vector<Vertex> vertices =
+		{
+			Vertex::Register({-1.0f, -1.0f, depth}, {0.0f, 0.0f}),
+			Vertex::Register({1.0f, -1.0f, depth}, {1.0f, 0.0f}),
+			Vertex::Register({1.0f, 1.0f, depth}, {1.0f, 1.0f}),
+			Vertex::Register({-1.0f, 1.0f, depth}, {0.0f, 1.0f})
+		};
+
+		Mesh& mesh = layers.emplace_back(Mesh::Register(std::format("layer{}", i), vertices, { 0, 1, 2, 2, 3, 0 }, "default"));
+		mesh.Generate();
+	}
+}
+
+void SubmitScene(uint64_t frame)
+{
+	for (uint32_t i = 0; i < BENCHMARK_LAYERS; i++)
+	{
+		uint32_t layer = (uint32_t)((i + frame) % BENCHMARK_LAYERS);
+
+		layers[layer].Submit(1.0f - (layer + 1) / (float)(BENCHMARK_LAYERS + 1));
+	}
+}
+
+std::string FormatSummary(const FrameTimeSummary& summary)
+{
+	return std::format("{{\"mean\":{:.4f},\"p50\":{:.4f},\"p95\":{:.4f},\"p99\":{:.4f},\"max\":{:.4f}}}", summary.mean, summary.p50, summary.p95, summary.p99, summary.max);
+}
+
+void WriteResults(const std::string& path, uint64_t frames)
+{
+	std::ofstream file(path, std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		Logger_WriteConsole("Could not write benchmark results to " + path, LogLevel::WARNING);
+		return;
+	}
+
+	file << "{\n";
+	file << std::format("\t\"frames\": {},\n", frames);
+	file << std::format("\t\"layers\": {},\n", BENCHMARK_LAYERS);
+	file << std::format("\t\"depthPrePass\": {},\n", RenderQueue::depthPrePass ? "true" : "false");
+	file << std::format("\t\"dynamicRendering\": {},\n", RenderGraphExecutor::UsesDynamicRendering() ? "true" : "false");
+	file << std::format("\t\"frameTime\": {},\n", FormatSummary(FrameStatistics::Summarize(&FrameTiming::frame)));
+	file << std::format("\t\"cpuSubmit\": {},\n", FormatSummary(FrameStatistics::Summarize(&FrameTiming::cpu)));
+	file << std::format("\t\"presentWait\": {},\n", FormatSummary(FrameStatistics::Summarize(&FrameTiming::wait)));
+
+	auto histogram = FrameStatistics::GetHistogram();
+
+	file << "\t\"histogram\": [";
+
+	for (size_t i = 0; i < histogram.size(); i++)
+	{
+		if (i < FrameStatistics::histogramEdges.size())
+			file << std::format("{}{{\"upTo\":{:.1f},\"count\":{}}}", i == 0 ? "" : ",", FrameStatistics::histogramEdges[i], histogram[i]);
+		else
+			file << std::format(",{{\"upTo\":null,\"count\":{}}}", histogram[i]);
+	}
+
+	file << "],\n";
+	file << "\t\"gpu\": {";
+
+	for (size_t i = 0; i < GpuProfiler::scopeOrder.size(); i++)
+	{
+		const std::string& name = GpuProfiler::scopeOrder[i];
+
+		GpuScopeStatistics statistics = GpuProfiler::GetStatistics(name);
+		PipelineCounterHistory counters = GpuProfiler::GetCounters(name);
+		PerformanceCounterHistory performance = GpuProfiler::GetPerformanceCounters(name);
+
+		file << std::format("{}\"{}\":{{\"mean\":{:.4f},\"p50\":{:.4f},\"p95\":{:.4f},\"p99\":{:.4f}", i == 0 ? "" : ",", Profiler::Escape(name.c_str()), statistics.average, statistics.p50, statistics.p95, statistics.p99);
+
+		if (counters.samples > 0)
+		{
+			file << std::format(",\"vertexInvocations\":{:.1f},\"primitives\":{:.1f},\"clippedPrimitives\":{:.1f},\"fragmentInvocations\":{:.1f}", counters.Average(&PipelineCounters::vertexInvocations),
+				counters.Average(&PipelineCounters::inputPrimitives), counters.Average(&PipelineCounters::clippingPrimitives), counters.Average(&PipelineCounters::fragmentInvocations));
+		}
+
+		for (size_t j = 0; performance.samples > 0 && j < PerformanceCounters::counters.size(); j++)
+			file << std::format(",\"{}\":{:.4f}", Profiler::Escape(PerformanceCounters::counters[j].name.c_str()), performance.total[j] / performance.samples);
+
+		file << "}";
+	}
+
+	file << "},\n";
+	file << std::format("\t\"overdraw\": {:.4f}\n", PipelineStatistics::total.GetOverdraw());
+	file << "}\n";
+
+	Logger_WriteConsole("Wrote benchmark results to " + path, LogLevel::INFO);
+}
+
+int main(int argc, char** argv)
+{
+	uint64_t frames = BENCHMARK_DEFAULT_FRAMES;
+	std::string output = BENCHMARK_DEFAULT_OUTPUT;
+	std::string configPath = Settings::GetConfigPath();
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+
+		if (argument == "--frames" && i + 1 < argc)
+			frames = std::stoull(argv[++i]);
+		else if (argument == "--output" && i + 1 < argc)
+			output = argv[++i];
+		else if (argument == "--depth-prepass")
+			RenderQueue::depthPrePass = true;
+		else if (argument == "--legacy-render-pass")
+			VulkanManager::preferDynamicRendering = false;
+		else if (argument == "--performance-counters")
+			PerformanceCounters::enabled = true;
+		else if (argument == "--config" && i + 1 < argc)
+			configPath = argv[++i];
+	}
+
+	Logger_Initialize();
+
+	CVars::LoadFile(configPath);
+	CVars::ParseArguments(argc, argv);
+	CVars::Lock();
+	CVars::LogSummary();
+
+	PipelineStatistics::enabled = true;
+
+	Window::Initialize({1280, 720}, "TerraVulkan Benchmark", false);
+
+	VulkanManager::PreInitialize();
+
+	ShaderManager::Register(Shader::Register("shaders/default", "default"));
+	ShaderManager::Generate();
+
+	TextureRegistry::Generate();
+
+	BuildScene();
+
+	uint64_t frame = 0;
+
+	VulkanManager::RequestRenderCall([&frame](VkCommandBuffer buffer)
+	{
+		SubmitScene(frame);
+
+		RenderQueue::Record(buffer);
+	});
+
+	VulkanManager::PostInitialize();
+
+	for (; frame < BENCHMARK_WARM_UP_FRAMES && !Window::ShouldClose(); frame++)
+	{
+		VulkanManager::Render();
+		Window::Update();
+	}
+
+	FrameStatistics::Reset(frames);
+
+	PipelineStatistics::ResetTotals();
+	PerformanceCounters::ResetTotals();
+
+	for (uint64_t measured = 0; measured < frames && !Window::ShouldClose(); measured++, frame++)
+	{
+		VulkanManager::Render();
+		Window::Update();
+	}
+
+	FrameStatistics::Flush();
+
+	vkDeviceWaitIdle(VulkanManager::device);
+
+	FrameStatistics::LogSummary();
+	GpuProfiler::LogSummary();
+	PipelineStatistics::LogSummary();
+	PerformanceCounters::LogSummary();
+	PresentWait::LogSummary();
+	AllocationTracker::LogSummary();
+
+	WriteResults(output, FrameStatistics::GetTimings().size());
+
+	ShaderManager::CleanUp();
+	TextureRegistry::CleanUp();
+
+	for (auto& layer : layers)
+		layer.CleanUp();
+
+	VulkanManager::CleanUp();
+	Window::CleanUp();
+	Logger_CleanUp();
+
+	return 0;
+}
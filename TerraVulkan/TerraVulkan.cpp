@@ -1,42 +1,187 @@
+#include <string>
 #include "core/Logger.hpp"
+#include "core/AllocationTracker.hpp"
+#include "core/CVar.hpp"
+#include "core/Settings.hpp"
+#include "core/Input.hpp"
 #include "core/VulkanManager.hpp"
+#include "core/RenderGraphTest.hpp"
+#include "core/LoopController.hpp"
+#include "core/Profiler.hpp"
 #include "core/Window.hpp"
 #include "render/Mesh.hpp"
+#include "render/RenderQueue.hpp"
 #include "render/ShaderManager.hpp"
+#include "render/ShaderHotReload.hpp"
+#include "render/TextureRegistry.hpp"
+#include "thread/FixedTimestepSimulation.hpp"
+
+#define HEADLESS_DEFAULT_FRAMES 300
+
+struct WorldState
+{
+	double time = 0.0;
+
+	static WorldState Interpolate(const WorldState& previous, const WorldState& current, float alpha)
+	{
+		return { previous.time + (current.time - previous.time) * alpha };
+	}
+};
 
 Mesh mesh = {};
+WorldState world = {};
 
-int main()
+InputSnapshot input = {};
+
+int main(int argc, char** argv)
 {
+	bool headless = false;
+	bool testRenderGraph = false;
+	uint64_t headlessFrames = HEADLESS_DEFAULT_FRAMES;
+	uint32_t profileFrames = 0;
+	double tickRate = SIMULATION_DEFAULT_TICK_RATE;
+	std::string configPath = Settings::GetConfigPath();
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+
+		if (argument == "--headless")
+			headless = true;
+		else if (argument == "--frames" && i + 1 < argc)
+			headlessFrames = std::stoull(argv[++i]);
+		else if (argument == "--depth-prepass")
+			RenderQueue::depthPrePass = true;
+		else if (argument == "--unsorted")
+			RenderQueue::sortFrontToBack = false;
+		else if (argument == "--profile-frames" && i + 1 < argc)
+			profileFrames = (uint32_t)std::stoul(argv[++i]);
+		else if (argument == "--legacy-render-pass")
+			VulkanManager::preferDynamicRendering = false;
+		else if (argument == "--fps-cap" && i + 1 < argc)
+			LoopController::targetFps = std::stod(argv[++i]);
+		else if (argument == "--tick-rate" && i + 1 < argc)
+			tickRate = std::stod(argv[++i]);
+		else if (argument == "--on-demand")
+			LoopController::renderOnDemand = true;
+		else if (argument == "--performance-counters")
+			PerformanceCounters::enabled = true;
+		else if (argument == "--test-render-graph")
+			testRenderGraph = true;
+		else if (argument == "--config" && i + 1 < argc)
+			configPath = argv[++i];
+	}
+
 	Logger_Initialize();
 
+	CVars::LoadFile(configPath);
+	CVars::ParseArguments(argc, argv);
+	CVars::Lock();
+	CVars::LogSummary();
+
+	TERRA_PROFILE_THREAD("Main");
+
 	Logger_WriteConsole("Hello, TerraVulkan!", LogLevel::INFO);
 
-	Window::Initialize({750, 450}, "TerraVulkan");
+	if (testRenderGraph)
+	{
+		int result = RenderGraphTest::Run();
+
+		Logger_CleanUp();
+
+		return result;
+	}
+
+	PipelineStatistics::enabled = headless;
+
+	Window::Initialize({750, 450}, "TerraVulkan", !headless);
 
 	VulkanManager::PreInitialize();
 	
 	ShaderManager::Register(Shader::Register("shaders/default", "default"));
 	ShaderManager::Generate();
 
+	TextureRegistry::Generate();
+
+#ifdef _DEBUG
+	ShaderHotReload::Initialize();
+#endif
+
 	mesh = Mesh::Register("test", {}, {}, "default");
 	mesh.GenerateTestTriangle();
 
 	VulkanManager::RequestRenderCall([](VkCommandBuffer buffer)
 	{
-		mesh.Render(buffer);
+		mesh.Submit();
+
+		RenderQueue::Record(buffer);
 	});
 
 	VulkanManager::PostInitialize();
 
-	while (!Window::ShouldClose())
+	if (profileFrames > 0)
+		Profiler::Capture(profileFrames);
+
+	// A hidden headless window never has focus, it must not be throttled like a background one
+	LoopController::throttleUnfocused = !headless;
+	LoopController::Initialize();
+	Input::Initialize();
+
+	FixedTimestepSimulation<WorldState> simulation([](WorldState& state, double step)
+	{
+		Input::Consume(input);
+
+		state.time += step;
+	}, {}, tickRate);
+
+	simulation.Start();
+
+	uint64_t frame = 0;
+
+	while (!Window::ShouldClose() && (!headless || frame < headlessFrames))
 	{
+		bool render = LoopController::BeginFrame();
+
+		Input::Update();
+
+#ifdef _DEBUG
+		ShaderHotReload::Update();
+#endif
+
+		if (!render)
+			continue;
+
+		world = simulation.Sample();
+
 		VulkanManager::Render();
 
-		Window::Update();
+		Profiler::EndFrame();
+
+		LoopController::EndFrame();
+
+		frame++;
 	}
 
+	FrameStatistics::Flush();
+
+	simulation.Stop();
+	LoopController::CleanUp();
+
+#ifdef _DEBUG
+	ShaderHotReload::CleanUp();
+#endif
+
+	FrameStatistics::LogSummary();
+	PipelineStatistics::LogSummary();
+	PerformanceCounters::LogSummary();
+	PresentWait::LogSummary();
+	GpuProfiler::LogSummary();
+	simulation.LogSummary();
+	Input::LogSummary();
+	AllocationTracker::LogSummary();
+
 	ShaderManager::CleanUp();
+	TextureRegistry::CleanUp();
 	mesh.CleanUp();
 	VulkanManager::CleanUp();
 	Window::CleanUp();
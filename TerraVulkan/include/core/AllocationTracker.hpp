@@ -0,0 +1,358 @@
+#ifndef ALLOCATION_TRACKER_HPP
+#define ALLOCATION_TRACKER_HPP
+
+#include <new>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <algorithm>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core/Logger.hpp"
+
+#define ALLOCATION_HEADER_SIZE 16
+
+#define VULKAN_ALLOCATOR AllocationTracker::GetVulkanCallbacks()
+
+#ifdef TERRA_TRACK_ALLOCATIONS
+#define TERRA_ALLOCATION_CONCAT_INNER(a, b) a##b
+#define TERRA_ALLOCATION_CONCAT(a, b) TERRA_ALLOCATION_CONCAT_INNER(a, b)
+#define TERRA_ALLOCATION_SCOPE(tag) AllocationScope TERRA_ALLOCATION_CONCAT(allocationScope, __LINE__)(tag)
+#else
+#define TERRA_ALLOCATION_SCOPE(tag) ((void)0)
+#endif
+
+enum class AllocationTag : uint32_t
+{
+    GENERAL,
+    RENDERER,
+    PIPELINE,
+    SHADER,
+    MESH,
+    TEXTURE,
+    VULKAN,
+    COUNT
+};
+
+struct AllocationCounters
+{
+    std::atomic<int64_t> liveBytes = 0;
+    std::atomic<int64_t> peakBytes = 0;
+    std::atomic<uint64_t> allocations = 0;
+    std::atomic<uint64_t> frameAllocations = 0;
+    uint64_t lastFrameAllocations = 0;
+};
+
+// Sits in front of every tracked block, 16 bytes so the pointer handed out keeps malloc's alignment
+struct AllocationHeader
+{
+    size_t size = 0;
+    AllocationTag tag = AllocationTag::GENERAL;
+    uint16_t offset = 0;
+    uint16_t scope = 0;
+};
+
+static_assert(sizeof(AllocationHeader) == ALLOCATION_HEADER_SIZE);
+
+namespace AllocationTracker
+{
+    constexpr std::array<const char*, (size_t)AllocationTag::COUNT> tagNames = { "General", "Renderer", "Pipeline", "Shader", "Mesh", "Texture", "Vulkan" };
+    constexpr std::array<const char*, 5> vulkanScopeNames = { "Command", "Object", "Cache", "Device", "Instance" };
+
+    std::array<AllocationCounters, (size_t)AllocationTag::COUNT> counters = {};
+    std::array<std::atomic<int64_t>, 5> vulkanScopeBytes = {};
+    std::atomic<int64_t> vulkanInternalBytes = 0;
+    uint64_t frames = 0;
+
+    thread_local AllocationTag currentTag = AllocationTag::GENERAL;
+
+    void OnAllocate(AllocationTag tag, size_t size)
+    {
+        AllocationCounters& counter = counters[(size_t)tag];
+
+        int64_t live = counter.liveBytes.fetch_add((int64_t)size, std::memory_order_relaxed) + (int64_t)size;
+        int64_t peak = counter.peakBytes.load(std::memory_order_relaxed);
+
+        while (live > peak && !counter.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+
+        counter.allocations.fetch_add(1, std::memory_order_relaxed);
+        counter.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void OnFree(AllocationTag tag, size_t size)
+    {
+        counters[(size_t)tag].liveBytes.fetch_sub((int64_t)size, std::memory_order_relaxed);
+    }
+
+    // Plain malloc underneath, nothing here may call back into operator new
+    void* Allocate(size_t size)
+    {
+        void* block = std::malloc(size + ALLOCATION_HEADER_SIZE);
+
+        if (block == nullptr)
+            return nullptr;
+
+        AllocationHeader* header = static_cast<AllocationHeader*>(block);
+
+        header->size = size;
+        header->tag = currentTag;
+        header->offset = ALLOCATION_HEADER_SIZE;
+
+        OnAllocate(header->tag, size);
+
+        return static_cast<char*>(block) + ALLOCATION_HEADER_SIZE;
+    }
+
+    void Free(void* pointer)
+    {
+        if (pointer == nullptr)
+            return;
+
+        AllocationHeader* header = reinterpret_cast<AllocationHeader*>(static_cast<char*>(pointer) - ALLOCATION_HEADER_SIZE);
+
+        OnFree(header->tag, header->size);
+
+        std::free(header);
+    }
+
+    void* AlignedAllocate(size_t size, size_t alignment)
+    {
+#ifdef _WIN32
+        return _aligned_malloc(size, alignment);
+#else
+        return std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif
+    }
+
+    void AlignedFree(void* block)
+    {
+#ifdef _WIN32
+        _aligned_free(block);
+#else
+        std::free(block);
+#endif
+    }
+
+    void* VKAPI_PTR VulkanAllocation(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope)
+    {
+        if (size == 0)
+            return nullptr;
+
+        alignment = std::max<size_t>(alignment, ALLOCATION_HEADER_SIZE);
+
+        char* block = static_cast<char*>(AlignedAllocate(alignment + size, alignment));
+
+        if (block == nullptr)
+            return nullptr;
+
+        AllocationHeader* header = reinterpret_cast<AllocationHeader*>(block + alignment - ALLOCATION_HEADER_SIZE);
+
+        header->size = size;
+        header->tag = AllocationTag::VULKAN;
+        header->offset = (uint16_t)alignment;
+        header->scope = (uint16_t)scope;
+
+        OnAllocate(AllocationTag::VULKAN, size);
+        vulkanScopeBytes[(size_t)scope].fetch_add((int64_t)size, std::memory_order_relaxed);
+
+        return block + alignment;
+    }
+
+    void VKAPI_PTR VulkanFree(void* userData, void* memory)
+    {
+        if (memory == nullptr)
+            return;
+
+        AllocationHeader* header = reinterpret_cast<AllocationHeader*>(static_cast<char*>(memory) - ALLOCATION_HEADER_SIZE);
+
+        OnFree(AllocationTag::VULKAN, header->size);
+        vulkanScopeBytes[header->scope].fetch_sub((int64_t)header->size, std::memory_order_relaxed);
+
+        AlignedFree(static_cast<char*>(memory) - header->offset);
+    }
+
+    void* VKAPI_PTR VulkanReallocation(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope)
+    {
+        if (original == nullptr)
+            return VulkanAllocation(userData, size, alignment, scope);
+
+        if (size == 0)
+        {
+            VulkanFree(userData, original);
+            return nullptr;
+        }
+
+        void* memory = VulkanAllocation(userData, size, alignment, scope);
+
+        if (memory == nullptr)
+            return nullptr;
+
+        AllocationHeader* header = reinterpret_cast<AllocationHeader*>(static_cast<char*>(original) - ALLOCATION_HEADER_SIZE);
+
+        std::memcpy(memory, original, std::min(size, header->size));
+
+        VulkanFree(userData, original);
+
+        return memory;
+    }
+
+    void VKAPI_PTR VulkanInternalAllocation(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope)
+    {
+        vulkanInternalBytes.fetch_add((int64_t)size, std::memory_order_relaxed);
+    }
+
+    void VKAPI_PTR VulkanInternalFree(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope)
+    {
+        vulkanInternalBytes.fetch_sub((int64_t)size, std::memory_order_relaxed);
+    }
+
+    const VkAllocationCallbacks* GetVulkanCallbacks()
+    {
+#ifdef TERRA_TRACK_ALLOCATIONS
+        static const VkAllocationCallbacks callbacks = { nullptr, VulkanAllocation, VulkanReallocation, VulkanFree, VulkanInternalAllocation, VulkanInternalFree };
+
+        return &callbacks;
+#else
+        return nullptr;
+#endif
+    }
+
+    bool Enabled()
+    {
+#ifdef TERRA_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void BeginFrame()
+    {
+        for (auto& counter : counters)
+            counter.lastFrameAllocations = counter.frameAllocations.exchange(0, std::memory_order_relaxed);
+
+        frames++;
+    }
+
+    int64_t GetLiveBytes(AllocationTag tag)
+    {
+        return counters[(size_t)tag].liveBytes.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetFrameAllocations(AllocationTag tag)
+    {
+        return counters[(size_t)tag].lastFrameAllocations;
+    }
+
+    void LogSummary()
+    {
+        if (!Enabled())
+            return;
+
+        for (size_t i = 0; i < counters.size(); i++)
+        {
+            const AllocationCounters& counter = counters[i];
+            uint64_t allocations = counter.allocations.load(std::memory_order_relaxed);
+
+            if (allocations == 0)
+                continue;
+
+            Logger_WriteConsole(std::format("{} heap: {:.1f} KiB live, {:.1f} KiB peak, {} allocations, {} last frame, {:.1f} per frame", tagNames[i],
+                counter.liveBytes.load(std::memory_order_relaxed) / 1024.0, counter.peakBytes.load(std::memory_order_relaxed) / 1024.0, allocations,
+                counter.lastFrameAllocations, frames > 0 ? allocations / (double)frames : 0.0), LogLevel::INFO);
+        }
+
+        std::string line = "Vulkan host memory by scope:";
+
+        for (size_t i = 0; i < vulkanScopeBytes.size(); i++)
+            line += std::format(" {} {:.1f} KiB", vulkanScopeNames[i], vulkanScopeBytes[i].load(std::memory_order_relaxed) / 1024.0);
+
+        line += std::format(", driver internal {:.1f} KiB", vulkanInternalBytes.load(std::memory_order_relaxed) / 1024.0);
+
+        Logger_WriteConsole(line, LogLevel::INFO);
+    }
+}
+
+struct AllocationScope
+{
+    AllocationTag previous = AllocationTag::GENERAL;
+
+    AllocationScope(AllocationTag tag)
+    {
+        previous = AllocationTracker::currentTag;
+        AllocationTracker::currentTag = tag;
+    }
+
+    ~AllocationScope()
+    {
+        AllocationTracker::currentTag = previous;
+    }
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+};
+
+// Replacement operators may not be inline, defining them here is fine since each executable is a single translation unit.
+// The over-aligned overloads are left to the runtime, they allocate separately and never see these headers
+#ifdef TERRA_TRACK_ALLOCATIONS
+void* operator new(size_t size)
+{
+    void* pointer = AllocationTracker::Allocate(size);
+
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+
+    return pointer;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return AllocationTracker::Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return AllocationTracker::Allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    AllocationTracker::Free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    AllocationTracker::Free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    AllocationTracker::Free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    AllocationTracker::Free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    AllocationTracker::Free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    AllocationTracker::Free(pointer);
+}
+#endif
+
+#endif // !ALLOCATION_TRACKER_HPP
@@ -0,0 +1,362 @@
+#ifndef CVAR_HPP
+#define CVAR_HPP
+
+#include <string>
+#include <vector>
+#include <format>
+#include <fstream>
+#include <charconv>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+#include "core/Logger.hpp"
+
+#define CVAR_FLAG_NONE 0
+#define CVAR_FLAG_STARTUP 1
+
+class CVarBase;
+
+namespace CVars
+{
+    // Function local so cvars defined in any header can register during static initialization, whatever order it runs in
+    inline std::unordered_map<std::string, CVarBase*>& GetRegistry()
+    {
+        static std::unordered_map<std::string, CVarBase*> registry;
+        return registry;
+    }
+
+    inline bool locked = false;
+}
+
+class CVarBase
+{
+
+public:
+
+    CVarBase(const std::string& name, const std::string& description, uint32_t flags) : name(name), description(description), flags(flags)
+    {
+        CVars::GetRegistry()[name] = this;
+    }
+
+    virtual ~CVarBase() = default;
+
+    CVarBase(const CVarBase&) = delete;
+    CVarBase& operator=(const CVarBase&) = delete;
+
+    virtual bool Parse(const std::string& text) = 0;
+    virtual std::string ToString() const = 0;
+    virtual bool IsDefault() const = 0;
+
+    const std::string& GetName() const
+    {
+        return name;
+    }
+
+    const std::string& GetDescription() const
+    {
+        return description;
+    }
+
+    uint32_t GetFlags() const
+    {
+        return flags;
+    }
+
+protected:
+
+    std::string name;
+    std::string description;
+    uint32_t flags = CVAR_FLAG_NONE;
+
+    bool CanChange() const
+    {
+        if ((flags & CVAR_FLAG_STARTUP) == 0 || !CVars::locked)
+            return true;
+
+        Logger_WriteConsole(std::format("'{}' is only read at startup, set it in the config file or on the command line", name), LogLevel::WARNING);
+
+        return false;
+    }
+};
+
+namespace CVars
+{
+    inline bool ParseValue(const std::string& text, bool& value)
+    {
+        if (text == "1" || text == "true" || text == "on")
+            value = true;
+        else if (text == "0" || text == "false" || text == "off")
+            value = false;
+        else
+            return false;
+
+        return true;
+    }
+
+    template<typename T> requires std::is_arithmetic_v<T>
+    bool ParseValue(const std::string& text, T& value)
+    {
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    inline bool ParseValue(const std::string& text, std::string& value)
+    {
+        value = text;
+        return true;
+    }
+
+    inline bool ParseValue(const std::string& text, glm::vec4& value)
+    {
+        std::string separated = text;
+        std::replace(separated.begin(), separated.end(), ',', ' ');
+
+        glm::vec4 parsed = {};
+        const char* cursor = separated.data();
+        const char* end = separated.data() + separated.size();
+
+        for (int i = 0; i < 4; i++)
+        {
+            while (cursor < end && *cursor == ' ')
+                cursor++;
+
+            auto [next, error] = std::from_chars(cursor, end, parsed[i]);
+
+            if (error != std::errc())
+                return false;
+
+            cursor = next;
+        }
+
+        while (cursor < end && *cursor == ' ')
+            cursor++;
+
+        if (cursor != end)
+            return false;
+
+        value = parsed;
+        return true;
+    }
+
+    inline std::string FormatValue(bool value)
+    {
+        return value ? "true" : "false";
+    }
+
+    template<typename T> requires std::is_arithmetic_v<T>
+    std::string FormatValue(T value)
+    {
+        return std::format("{}", value);
+    }
+
+    inline std::string FormatValue(const std::string& value)
+    {
+        return value;
+    }
+
+    inline std::string FormatValue(const glm::vec4& value)
+    {
+        return std::format("{} {} {} {}", value.x, value.y, value.z, value.w);
+    }
+}
+
+template<typename T>
+class CVar : public CVarBase
+{
+
+public:
+
+    using Callback = std::function<void(const T&)>;
+
+    CVar(const std::string& name, const T& defaultValue, const std::string& description = "", uint32_t flags = CVAR_FLAG_NONE) : CVarBase(name, description, flags), value(defaultValue), defaultValue(defaultValue) { }
+
+    const T& Get() const
+    {
+        return value;
+    }
+
+    const T* GetPointer() const
+    {
+        return &value;
+    }
+
+    operator const T&() const
+    {
+        return value;
+    }
+
+    const T& GetDefault() const
+    {
+        return defaultValue;
+    }
+
+    void Set(const T& newValue)
+    {
+        if (newValue == value || !CanChange())
+            return;
+
+        value = newValue;
+
+        for (auto& callback : callbacks)
+            callback(value);
+    }
+
+    void OnChange(Callback callback)
+    {
+        callbacks.push_back(std::move(callback));
+    }
+
+    bool Parse(const std::string& text) override
+    {
+        T parsed = value;
+
+        if (!CVars::ParseValue(text, parsed))
+            return false;
+
+        Set(parsed);
+        return true;
+    }
+
+    std::string ToString() const override
+    {
+        return CVars::FormatValue(value);
+    }
+
+    bool IsDefault() const override
+    {
+        return value == defaultValue;
+    }
+
+private:
+
+    T value;
+    T defaultValue;
+
+    std::vector<Callback> callbacks;
+};
+
+namespace CVars
+{
+    inline CVarBase* Find(const std::string& name)
+    {
+        auto iterator = GetRegistry().find(name);
+
+        return iterator != GetRegistry().end() ? iterator->second : nullptr;
+    }
+
+    template<typename T>
+    CVar<T>* Find(const std::string& name)
+    {
+        return dynamic_cast<CVar<T>*>(Find(name));
+    }
+
+    inline bool Set(const std::string& name, const std::string& text)
+    {
+        CVarBase* cvar = Find(name);
+
+        if (cvar == nullptr)
+        {
+            Logger_WriteConsole(std::format("Unknown setting '{}'", name), LogLevel::WARNING);
+            return false;
+        }
+
+        if (!cvar->Parse(text))
+        {
+            Logger_WriteConsole(std::format("'{}' is not a valid value for '{}'", text, name), LogLevel::WARNING);
+            return false;
+        }
+
+        return true;
+    }
+
+    inline std::string Trim(const std::string& text)
+    {
+        size_t first = text.find_first_not_of(" \t\r\n");
+
+        if (first == std::string::npos)
+            return "";
+
+        return text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+    }
+
+    inline bool LoadFile(const std::string& path)
+    {
+        std::ifstream file(path);
+
+        if (!file.is_open())
+            return false;
+
+        std::string line;
+        uint32_t applied = 0;
+
+        while (std::getline(file, line))
+        {
+            line = Trim(line.substr(0, line.find('#')));
+
+            if (line.empty())
+                continue;
+
+            size_t separator = line.find('=');
+
+            if (separator == std::string::npos)
+            {
+                Logger_WriteConsole(std::format("Ignoring '{}' in {}, expected name = value", line, path), LogLevel::WARNING);
+                continue;
+            }
+
+            if (Set(Trim(line.substr(0, separator)), Trim(line.substr(separator + 1))))
+                applied++;
+        }
+
+        Logger_WriteConsole(std::format("Loaded {} settings from {}", applied, path), LogLevel::INFO);
+
+        return true;
+    }
+
+    inline void ParseArguments(int argc, char** argv)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string argument = argv[i];
+
+            if (argument.size() < 2 || argument[0] != '+')
+                continue;
+
+            size_t separator = argument.find('=');
+
+            if (separator == std::string::npos)
+            {
+                Logger_WriteConsole(std::format("Ignoring '{}', expected +name=value", argument), LogLevel::WARNING);
+                continue;
+            }
+
+            Set(argument.substr(1, separator - 1), argument.substr(separator + 1));
+        }
+    }
+
+    inline void Lock()
+    {
+        locked = true;
+    }
+
+    inline void LogSummary()
+    {
+        std::vector<CVarBase*> changed;
+
+        for (auto& [name, cvar] : GetRegistry())
+        {
+            if (!cvar->IsDefault())
+                changed.push_back(cvar);
+        }
+
+        std::sort(changed.begin(), changed.end(), [](CVarBase* a, CVarBase* b) { return a->GetName() < b->GetName(); });
+
+        for (CVarBase* cvar : changed)
+            Logger_WriteConsole(std::format("Setting {} = {}", cvar->GetName(), cvar->ToString()), LogLevel::INFO);
+    }
+}
+
+#endif // !CVAR_HPP
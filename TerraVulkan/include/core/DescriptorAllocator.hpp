@@ -0,0 +1,378 @@
+#ifndef DESCRIPTOR_ALLOCATOR_HPP
+#define DESCRIPTOR_ALLOCATOR_HPP
+
+#include <array>
+#include <vector>
+#include <mutex>
+#include <algorithm>
+#include <unordered_map>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core/AllocationTracker.hpp"
+#include "core/Logger.hpp"
+#include "core/LayoutCache.hpp"
+#include "core/PipelineManager.hpp"
+#include "util/Hash.hpp"
+
+#define MAX_DESCRIPTOR_THREADS 16
+#define DESCRIPTOR_POOL_INITIAL_SETS 64
+#define DESCRIPTOR_POOL_MAX_SETS 4096
+
+struct DescriptorWrite
+{
+    uint32_t binding = 0;
+    VkDescriptorType type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+    VkDescriptorBufferInfo buffer = {};
+    VkDescriptorImageInfo image = {};
+
+    static DescriptorWrite Buffer(uint32_t binding, VkDescriptorType type, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+    {
+        DescriptorWrite write = {};
+
+        write.binding = binding;
+        write.type = type;
+        write.buffer = { buffer, offset, range };
+
+        return write;
+    }
+
+    static DescriptorWrite Image(uint32_t binding, VkDescriptorType type, VkImageView view, VkSampler sampler, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+    {
+        DescriptorWrite write = {};
+
+        write.binding = binding;
+        write.type = type;
+        write.image = { sampler, view, layout };
+
+        return write;
+    }
+
+    bool IsImage() const
+    {
+        return type == VK_DESCRIPTOR_TYPE_SAMPLER || type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
+            type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE || type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE || type == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    }
+
+    bool Matches(const DescriptorWrite& other) const
+    {
+        if (binding != other.binding || type != other.type)
+            return false;
+
+        if (IsImage())
+            return image.imageView == other.image.imageView && image.sampler == other.image.sampler && image.imageLayout == other.image.imageLayout;
+
+        return buffer.buffer == other.buffer.buffer && buffer.offset == other.buffer.offset && buffer.range == other.buffer.range;
+    }
+};
+
+struct DescriptorPoolChain
+{
+    std::vector<VkDescriptorPool> pools = {};
+    size_t current = 0;
+    uint32_t nextSize = DESCRIPTOR_POOL_INITIAL_SETS;
+};
+
+struct StaticDescriptorSet
+{
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    std::vector<DescriptorWrite> writes = {};
+    VkDescriptorSet set = VK_NULL_HANDLE;
+
+    bool Matches(VkDescriptorSetLayout otherLayout, const std::vector<DescriptorWrite>& otherWrites) const
+    {
+        return layout == otherLayout && std::equal(writes.begin(), writes.end(), otherWrites.begin(), otherWrites.end(), [](const DescriptorWrite& a, const DescriptorWrite& b) { return a.Matches(b); });
+    }
+};
+
+namespace DescriptorAllocator
+{
+    std::array<std::vector<DescriptorPoolChain>, MAX_DESCRIPTOR_THREADS> threadPools;
+    std::vector<uint32_t> freeThreadSlots;
+    uint32_t nextThreadSlot = 0;
+    std::mutex slotMutex;
+    size_t currentFrame = 0;
+
+    DescriptorPoolChain staticPools;
+    std::unordered_multimap<uint64_t, StaticDescriptorSet> staticSets;
+    std::mutex staticMutex;
+
+    VkDevice device;
+
+    void Initialize(VkDevice device, size_t framesInFlight)
+    {
+        DescriptorAllocator::device = device;
+
+        for (auto& frames : threadPools)
+            frames.resize(framesInFlight);
+    }
+
+    VkDescriptorPool CreatePool(uint32_t maxSets)
+    {
+        const std::pair<VkDescriptorType, uint32_t> ratios[] =
+        {
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2 },
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1 },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1 },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1 },
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 },
+            { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1 },
+            { VK_DESCRIPTOR_TYPE_SAMPLER, 1 },
+            { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1 }
+        };
+
+        std::vector<VkDescriptorPoolSize> sizes;
+
+        for (const auto& [type, ratio] : ratios)
+            sizes.push_back({ type, ratio * maxSets });
+
+        VkDescriptorPoolCreateInfo creationInformation = {};
+
+        creationInformation.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        creationInformation.maxSets = maxSets;
+        creationInformation.poolSizeCount = static_cast<uint32_t>(sizes.size());
+        creationInformation.pPoolSizes = sizes.data();
+
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+
+        if (vkCreateDescriptorPool(device, &creationInformation, VULKAN_ALLOCATOR, &pool) != VK_SUCCESS)
+            Logger_ThrowError("VK_FAILURE", "Failed to create descriptor pool!", true);
+
+        return pool;
+    }
+
+    VkDescriptorSet AllocateFrom(DescriptorPoolChain& chain, VkDescriptorSetLayout layout)
+    {
+        while (true)
+        {
+            bool created = chain.current == chain.pools.size();
+
+            if (created)
+            {
+                chain.pools.push_back(CreatePool(chain.nextSize));
+                chain.nextSize = std::min(chain.nextSize * 2, (uint32_t)DESCRIPTOR_POOL_MAX_SETS);
+            }
+
+            VkDescriptorSetAllocateInfo allocationInformation = {};
+
+            allocationInformation.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocationInformation.descriptorPool = chain.pools[chain.current];
+            allocationInformation.descriptorSetCount = 1;
+            allocationInformation.pSetLayouts = &layout;
+
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            VkResult result = vkAllocateDescriptorSets(device, &allocationInformation, &set);
+
+            if (result == VK_SUCCESS)
+                return set;
+
+            // Vulkan 1.0 drivers may report an exhausted pool with any error, so only a fresh pool failing is fatal
+            if (created)
+            {
+                Logger_ThrowError("VK_FAILURE", "Failed to allocate descriptor set!", true);
+                return VK_NULL_HANDLE;
+            }
+
+            chain.current++;
+        }
+    }
+
+    uint32_t AcquireThreadSlot()
+    {
+        std::lock_guard<std::mutex> lock(slotMutex);
+
+        if (!freeThreadSlots.empty())
+        {
+            uint32_t slot = freeThreadSlots.back();
+            freeThreadSlots.pop_back();
+
+            return slot;
+        }
+
+        if (nextThreadSlot >= MAX_DESCRIPTOR_THREADS)
+        {
+            Logger_ThrowError("THREAD_FAILURE", "Too many threads are allocating descriptor sets!", true);
+            return UINT32_MAX;
+        }
+
+        return nextThreadSlot++;
+    }
+
+    void ReleaseThreadSlot(uint32_t slot)
+    {
+        std::lock_guard<std::mutex> lock(slotMutex);
+        freeThreadSlots.push_back(slot);
+    }
+
+    struct ThreadSlot
+    {
+        uint32_t index = UINT32_MAX;
+
+        ~ThreadSlot()
+        {
+            if (index != UINT32_MAX)
+                ReleaseThreadSlot(index);
+        }
+    };
+
+    thread_local ThreadSlot threadSlot;
+
+    DescriptorPoolChain& GetThreadChain()
+    {
+        if (threadSlot.index == UINT32_MAX)
+            threadSlot.index = AcquireThreadSlot();
+
+        return threadPools[threadSlot.index][currentFrame];
+    }
+
+    void BeginFrame(size_t frame)
+    {
+        currentFrame = frame;
+
+        for (auto& frames : threadPools)
+        {
+            if (frames.empty())
+                continue;
+
+            DescriptorPoolChain& chain = frames[frame];
+
+            for (VkDescriptorPool pool : chain.pools)
+                vkResetDescriptorPool(device, pool, 0);
+
+            chain.current = 0;
+        }
+    }
+
+    VkDescriptorSet Allocate(VkDescriptorSetLayout layout)
+    {
+        return AllocateFrom(GetThreadChain(), layout);
+    }
+
+    void Write(VkDescriptorSet set, const std::vector<DescriptorWrite>& writes)
+    {
+        std::vector<VkWriteDescriptorSet> descriptorWrites(writes.size());
+
+        for (size_t i = 0; i < writes.size(); i++)
+        {
+            VkWriteDescriptorSet& descriptorWrite = descriptorWrites[i];
+
+            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrite.dstSet = set;
+            descriptorWrite.dstBinding = writes[i].binding;
+            descriptorWrite.descriptorCount = 1;
+            descriptorWrite.descriptorType = writes[i].type;
+
+            if (writes[i].IsImage())
+                descriptorWrite.pImageInfo = &writes[i].image;
+            else
+                descriptorWrite.pBufferInfo = &writes[i].buffer;
+        }
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+    }
+
+    VkDescriptorSet Allocate(VkDescriptorSetLayout layout, const std::vector<DescriptorWrite>& writes)
+    {
+        VkDescriptorSet set = Allocate(layout);
+
+        if (set != VK_NULL_HANDLE)
+            Write(set, writes);
+
+        return set;
+    }
+
+    VkDescriptorSet GetStaticSet(VkDescriptorSetLayout layout, const std::vector<DescriptorWrite>& writes)
+    {
+        uint64_t hash = Hash::Combine(HASH_FNV_OFFSET, layout);
+
+        for (const auto& write : writes)
+        {
+            hash = Hash::Combine(hash, write.binding);
+            hash = Hash::Combine(hash, write.type);
+
+            if (write.IsImage())
+            {
+                hash = Hash::Combine(hash, write.image.imageView);
+                hash = Hash::Combine(hash, write.image.sampler);
+                hash = Hash::Combine(hash, write.image.imageLayout);
+            }
+            else
+            {
+                hash = Hash::Combine(hash, write.buffer.buffer);
+                hash = Hash::Combine(hash, write.buffer.offset);
+                hash = Hash::Combine(hash, write.buffer.range);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(staticMutex);
+
+        auto [begin, end] = staticSets.equal_range(hash);
+
+        for (auto found = begin; found != end; found++)
+        {
+            if (found->second.Matches(layout, writes))
+                return found->second.set;
+        }
+
+        VkDescriptorSet set = AllocateFrom(staticPools, layout);
+
+        if (set == VK_NULL_HANDLE)
+            return set;
+
+        Write(set, writes);
+
+        staticSets.insert({ hash, { layout, writes, set } });
+
+        return set;
+    }
+
+    void ClearStaticSets()
+    {
+        std::lock_guard<std::mutex> lock(staticMutex);
+
+        vkDeviceWaitIdle(device);
+
+        for (VkDescriptorPool pool : staticPools.pools)
+            vkResetDescriptorPool(device, pool, 0);
+
+        staticPools.current = 0;
+        staticSets.clear();
+    }
+
+    void Bind(VkCommandBuffer commandBuffer, PipelineHandle pipeline, uint32_t setIndex, VkDescriptorSet set, const std::vector<uint32_t>& dynamicOffsets = {})
+    {
+        pipeline = PipelineManager::Resolve(pipeline);
+
+        if (pipeline != INVALID_PIPELINE_HANDLE && !PipelineManager::IsReady(pipeline))
+            pipeline = PipelineManager::Resolve(PipelineManager::Get(pipeline).fallback);
+
+        if (pipeline == INVALID_PIPELINE_HANDLE || PipelineManager::Get(pipeline).layout == VK_NULL_HANDLE)
+            return;
+
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineManager::Get(pipeline).layout, setIndex, 1, &set, static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.data());
+    }
+
+    void CleanUp()
+    {
+        for (auto& frames : threadPools)
+        {
+            for (auto& chain : frames)
+            {
+                for (VkDescriptorPool pool : chain.pools)
+                    vkDestroyDescriptorPool(device, pool, VULKAN_ALLOCATOR);
+            }
+
+            frames.clear();
+        }
+
+        for (VkDescriptorPool pool : staticPools.pools)
+            vkDestroyDescriptorPool(device, pool, VULKAN_ALLOCATOR);
+
+        staticPools = {};
+        staticSets.clear();
+    }
+}
+
+#endif // !DESCRIPTOR_ALLOCATOR_HPP
@@ -0,0 +1,244 @@
+#ifndef FRAME_ALLOCATOR_HPP
+#define FRAME_ALLOCATOR_HPP
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <cstring>
+#include <algorithm>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core/AllocationTracker.hpp"
+#include "core/Logger.hpp"
+
+#define FRAME_ALLOCATOR_INITIAL_SIZE (4ull * 1024 * 1024)
+
+struct FrameAllocation
+{
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    void* data = nullptr;
+
+    bool Valid() const
+    {
+        return buffer != VK_NULL_HANDLE;
+    }
+
+    uint32_t GetDynamicOffset() const
+    {
+        return static_cast<uint32_t>(offset);
+    }
+};
+
+struct FrameArena
+{
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize capacity = 0;
+    char* mapped = nullptr;
+
+    std::atomic<VkDeviceSize> head = 0;
+
+    std::mutex overflowMutex;
+    std::vector<std::unique_ptr<FrameArena>> overflow;
+};
+
+namespace FrameAllocator
+{
+    std::vector<std::unique_ptr<FrameArena>> arenas;
+    size_t currentFrame = 0;
+    VkDeviceSize alignment = 256;
+
+    VkDevice device;
+    VkPhysicalDevice physicalDevice;
+
+    bool FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, uint32_t& index)
+    {
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+        for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+        {
+            if ((typeFilter & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+            {
+                index = i;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void CreateArena(FrameArena& arena, VkDeviceSize capacity)
+    {
+        VkBufferCreateInfo bufferInformation = {};
+
+        bufferInformation.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInformation.size = capacity;
+        bufferInformation.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        bufferInformation.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateBuffer(device, &bufferInformation, VULKAN_ALLOCATOR, &arena.buffer) != VK_SUCCESS)
+            Logger_ThrowError("VK_FAILURE", "Failed to create frame allocator buffer!", true);
+
+        VkMemoryRequirements memoryRequirements;
+        vkGetBufferMemoryRequirements(device, arena.buffer, &memoryRequirements);
+
+        VkMemoryAllocateInfo allocationInformation = {};
+
+        allocationInformation.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocationInformation.allocationSize = memoryRequirements.size;
+
+        // Prefer host visible device memory (resizable BAR) so the GPU reads per-draw data without crossing the bus
+        if (!FindMemoryType(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, allocationInformation.memoryTypeIndex) &&
+            !FindMemoryType(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, allocationInformation.memoryTypeIndex))
+            Logger_ThrowError("VK_FAILURE", "Failed to find suitable memory type!", true);
+
+        if (vkAllocateMemory(device, &allocationInformation, VULKAN_ALLOCATOR, &arena.memory) != VK_SUCCESS)
+            Logger_ThrowError("VK_FAILURE", "Failed to allocate frame allocator memory!", true);
+
+        vkBindBufferMemory(device, arena.buffer, arena.memory, 0);
+
+        void* data = nullptr;
+        vkMapMemory(device, arena.memory, 0, capacity, 0, &data);
+
+        arena.mapped = static_cast<char*>(data);
+        arena.capacity = capacity;
+        arena.head.store(0);
+    }
+
+    void DestroyArena(FrameArena& arena)
+    {
+        if (arena.memory != VK_NULL_HANDLE)
+            vkUnmapMemory(device, arena.memory);
+
+        vkDestroyBuffer(device, arena.buffer, VULKAN_ALLOCATOR);
+        vkFreeMemory(device, arena.memory, VULKAN_ALLOCATOR);
+
+        arena.buffer = VK_NULL_HANDLE;
+        arena.memory = VK_NULL_HANDLE;
+        arena.mapped = nullptr;
+    }
+
+    void Initialize(VkDevice device, VkPhysicalDevice physicalDevice, size_t framesInFlight)
+    {
+        FrameAllocator::device = device;
+        FrameAllocator::physicalDevice = physicalDevice;
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+        alignment = std::max(properties.limits.minUniformBufferOffsetAlignment, properties.limits.minStorageBufferOffsetAlignment);
+
+        for (size_t i = 0; i < framesInFlight; i++)
+        {
+            arenas.push_back(std::make_unique<FrameArena>());
+            CreateArena(*arenas.back(), FRAME_ALLOCATOR_INITIAL_SIZE);
+        }
+    }
+
+    void BeginFrame(size_t frame)
+    {
+        currentFrame = frame;
+
+        FrameArena& arena = *arenas[frame];
+
+        if (!arena.overflow.empty())
+        {
+            VkDeviceSize required = arena.capacity;
+
+            for (auto& block : arena.overflow)
+            {
+                required += block->head.load();
+                DestroyArena(*block);
+            }
+
+            arena.overflow.clear();
+
+            VkDeviceSize capacity = arena.capacity * 2;
+
+            while (capacity < required)
+                capacity *= 2;
+
+            Logger_WriteConsole("Frame allocator ran out of space, growing to " + std::to_string(capacity / 1024) + " KiB", LogLevel::WARNING);
+
+            DestroyArena(arena);
+            CreateArena(arena, capacity);
+        }
+
+        arena.head.store(0, std::memory_order_relaxed);
+    }
+
+    FrameAllocation AllocateOverflow(FrameArena& arena, VkDeviceSize alignedSize, VkDeviceSize size)
+    {
+        std::lock_guard<std::mutex> lock(arena.overflowMutex);
+
+        if (arena.overflow.empty() || arena.overflow.back()->head.load() + alignedSize > arena.overflow.back()->capacity)
+        {
+            VkDeviceSize capacity = std::max(arena.capacity, alignedSize);
+
+            Logger_WriteConsole("Frame allocator ran out of space, adding a " + std::to_string(capacity / 1024) + " KiB block for this frame", LogLevel::WARNING);
+
+            arena.overflow.push_back(std::make_unique<FrameArena>());
+            CreateArena(*arena.overflow.back(), capacity);
+        }
+
+        FrameArena& block = *arena.overflow.back();
+        VkDeviceSize offset = block.head.fetch_add(alignedSize, std::memory_order_relaxed);
+
+        return { block.buffer, offset, size, block.mapped + offset };
+    }
+
+    FrameAllocation Allocate(VkDeviceSize size)
+    {
+        FrameArena& arena = *arenas[currentFrame];
+
+        VkDeviceSize alignedSize = (size + alignment - 1) & ~(alignment - 1);
+        VkDeviceSize offset = arena.head.fetch_add(alignedSize, std::memory_order_relaxed);
+
+        if (offset + alignedSize > arena.capacity)
+            return AllocateOverflow(arena, alignedSize, size);
+
+        return { arena.buffer, offset, size, arena.mapped + offset };
+    }
+
+    FrameAllocation Push(const void* data, VkDeviceSize size)
+    {
+        FrameAllocation allocation = Allocate(size);
+
+        if (allocation.Valid())
+            memcpy(allocation.data, data, (size_t)size);
+
+        return allocation;
+    }
+
+    template<typename T>
+    FrameAllocation Push(const T& value)
+    {
+        return Push(&value, sizeof(T));
+    }
+
+    VkBuffer GetBuffer()
+    {
+        return arenas[currentFrame]->buffer;
+    }
+
+    void CleanUp()
+    {
+        for (auto& arena : arenas)
+        {
+            for (auto& block : arena->overflow)
+                DestroyArena(*block);
+
+            DestroyArena(*arena);
+        }
+
+        arenas.clear();
+    }
+}
+
+#endif // !FRAME_ALLOCATOR_HPP
@@ -0,0 +1,207 @@
+#ifndef FRAME_STATISTICS_HPP
+#define FRAME_STATISTICS_HPP
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <format>
+#include <algorithm>
+
+#include "core/Logger.hpp"
+
+#define FRAME_STATISTICS_HISTORY 4096
+#define FRAME_HISTOGRAM_BUCKETS 10
+
+struct FrameTiming
+{
+    float frame = 0.0f;
+    float cpu = 0.0f;
+    float wait = 0.0f;
+};
+
+struct FrameTimeSummary
+{
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+namespace FrameStatistics
+{
+    constexpr std::array<float, FRAME_HISTOGRAM_BUCKETS> histogramEdges = { 2.0f, 4.0f, 6.9f, 8.3f, 11.1f, 16.7f, 20.0f, 33.3f, 50.0f, 100.0f };
+
+    std::vector<FrameTiming> timings = std::vector<FrameTiming>(FRAME_STATISTICS_HISTORY);
+    size_t next = 0;
+    uint64_t count = 0;
+
+    std::chrono::steady_clock::time_point frameStart = {};
+    std::chrono::steady_clock::duration waited = {};
+    std::chrono::steady_clock::duration waitedBeforeSubmit = {};
+    float cpu = 0.0f;
+    bool pending = false;
+
+    float ToMilliseconds(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<float, std::milli>(duration).count();
+    }
+
+    void Reset(size_t history = FRAME_STATISTICS_HISTORY)
+    {
+        timings.assign(std::max<size_t>(history, 1), {});
+        next = 0;
+        count = 0;
+        pending = false;
+    }
+
+    void CompleteFrame(std::chrono::steady_clock::time_point now)
+    {
+        if (!pending)
+            return;
+
+        timings[next].frame = ToMilliseconds(now - frameStart);
+        next = (next + 1) % timings.size();
+        count++;
+        pending = false;
+    }
+
+    // The last frame before a summary has no next frame to complete it
+    void Flush()
+    {
+        CompleteFrame(std::chrono::steady_clock::now());
+    }
+
+    // A frame's length is only known once the next one starts, so its sample is completed here
+    void BeginFrame()
+    {
+        auto now = std::chrono::steady_clock::now();
+
+        CompleteFrame(now);
+
+        frameStart = now;
+
+        waited = {};
+        waitedBeforeSubmit = {};
+        cpu = 0.0f;
+    }
+
+    void AddWait(std::chrono::steady_clock::duration duration)
+    {
+        waited += duration;
+    }
+
+    void EndSubmit()
+    {
+        waitedBeforeSubmit = waited;
+        cpu = ToMilliseconds(std::chrono::steady_clock::now() - frameStart - waitedBeforeSubmit);
+    }
+
+    void EndFrame()
+    {
+        timings[next] = { 0.0f, cpu, ToMilliseconds(waited) };
+        pending = true;
+    }
+
+    std::vector<FrameTiming> GetTimings()
+    {
+        size_t size = (size_t)std::min<uint64_t>(count, timings.size());
+        std::vector<FrameTiming> ordered;
+
+        ordered.reserve(size);
+
+        for (size_t i = 0; i < size; i++)
+            ordered.push_back(timings[(next + timings.size() - size + i) % timings.size()]);
+
+        return ordered;
+    }
+
+    FrameTimeSummary Summarize(std::vector<float> samples)
+    {
+        FrameTimeSummary summary = {};
+
+        if (samples.empty())
+            return summary;
+
+        std::sort(samples.begin(), samples.end());
+
+        double sum = 0.0;
+
+        for (float sample : samples)
+            sum += sample;
+
+        summary.mean = sum / samples.size();
+        summary.p50 = samples[(samples.size() - 1) * 50 / 100];
+        summary.p95 = samples[(samples.size() - 1) * 95 / 100];
+        summary.p99 = samples[(samples.size() - 1) * 99 / 100];
+        summary.max = samples.back();
+
+        return summary;
+    }
+
+    FrameTimeSummary Summarize(float FrameTiming::* field)
+    {
+        std::vector<float> samples;
+
+        for (const auto& timing : GetTimings())
+            samples.push_back(timing.*field);
+
+        return Summarize(samples);
+    }
+
+    std::array<uint64_t, FRAME_HISTOGRAM_BUCKETS + 1> GetHistogram()
+    {
+        std::array<uint64_t, FRAME_HISTOGRAM_BUCKETS + 1> histogram = {};
+
+        for (const auto& timing : GetTimings())
+        {
+            auto bucket = std::lower_bound(histogramEdges.begin(), histogramEdges.end(), timing.frame);
+            histogram[bucket - histogramEdges.begin()]++;
+        }
+
+        return histogram;
+    }
+
+    std::string FormatSummary(const FrameTimeSummary& summary)
+    {
+        return std::format("{:.2f} ms mean, p50 {:.2f}, p95 {:.2f}, p99 {:.2f}, max {:.2f}", summary.mean, summary.p50, summary.p95, summary.p99, summary.max);
+    }
+
+    void LogSummary()
+    {
+        size_t frames = GetTimings().size();
+
+        if (frames == 0)
+            return;
+
+        Logger_WriteConsole(std::format("Frame time over {} frames: {}", frames, FormatSummary(Summarize(&FrameTiming::frame))), LogLevel::INFO);
+        Logger_WriteConsole(std::format("CPU submit: {}", FormatSummary(Summarize(&FrameTiming::cpu))), LogLevel::INFO);
+        Logger_WriteConsole(std::format("Present wait: {}", FormatSummary(Summarize(&FrameTiming::wait))), LogLevel::INFO);
+
+        auto histogram = GetHistogram();
+        std::string line = "Frame time histogram:";
+
+        for (size_t i = 0; i < histogram.size(); i++)
+        {
+            if (i < histogramEdges.size())
+                line += std::format(" <={:.1f}ms: {}", histogramEdges[i], histogram[i]);
+            else
+                line += std::format(" slower: {}", histogram[i]);
+        }
+
+        Logger_WriteConsole(line, LogLevel::INFO);
+    }
+}
+
+struct FrameWaitScope
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    ~FrameWaitScope()
+    {
+        FrameStatistics::AddWait(std::chrono::steady_clock::now() - start);
+    }
+};
+
+#endif // !FRAME_STATISTICS_HPP
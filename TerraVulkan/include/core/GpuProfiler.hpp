@@ -0,0 +1,309 @@
+#ifndef GPU_PROFILER_HPP
+#define GPU_PROFILER_HPP
+
+#include <string>
+#include <vector>
+#include <format>
+#include <algorithm>
+#include <unordered_map>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core/AllocationTracker.hpp"
+#include "core/Logger.hpp"
+#include "core/PerformanceCounters.hpp"
+#include "core/PipelineStatistics.hpp"
+
+#define MAX_GPU_SCOPES 64
+#define GPU_PROFILER_HISTORY 240
+#define GPU_SCOPE_DROPPED UINT32_MAX
+
+struct GpuScope
+{
+    std::string name = "";
+    uint32_t depth = 0;
+
+    uint32_t beginQuery = 0;
+    uint32_t endQuery = 0;
+};
+
+struct GpuScopeStatistics
+{
+    double last = 0.0;
+    double average = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+
+    uint64_t samples = 0;
+};
+
+struct GpuScopeHistory
+{
+    std::vector<double> samples = std::vector<double>(GPU_PROFILER_HISTORY, 0.0);
+    size_t next = 0;
+    uint64_t count = 0;
+    uint32_t depth = 0;
+
+    void Add(double milliseconds)
+    {
+        samples[next] = milliseconds;
+        next = (next + 1) % samples.size();
+        count++;
+    }
+
+    GpuScopeStatistics GetStatistics() const
+    {
+        GpuScopeStatistics statistics = {};
+
+        size_t size = (size_t)std::min<uint64_t>(count, samples.size());
+
+        if (size == 0)
+            return statistics;
+
+        std::vector<double> sorted(samples.begin(), samples.begin() + size);
+        std::sort(sorted.begin(), sorted.end());
+
+        double sum = 0.0;
+
+        for (double sample : sorted)
+            sum += sample;
+
+        statistics.last = samples[(next + samples.size() - 1) % samples.size()];
+        statistics.average = sum / size;
+        statistics.p50 = sorted[(size - 1) * 50 / 100];
+        statistics.p95 = sorted[(size - 1) * 95 / 100];
+        statistics.p99 = sorted[(size - 1) * 99 / 100];
+        statistics.samples = count;
+
+        return statistics;
+    }
+};
+
+namespace GpuProfiler
+{
+    std::vector<VkQueryPool> queryPools;
+    std::vector<std::vector<GpuScope>> frameScopes;
+    std::vector<uint32_t> openScopes;
+    std::vector<bool> counterScopes;
+
+    std::unordered_map<std::string, GpuScopeHistory> history;
+    std::vector<std::string> scopeOrder;
+
+    uint32_t currentFrame = 0;
+    uint32_t nextQuery = 0;
+    uint64_t timestampMask = UINT64_MAX;
+    double timestampPeriod = 1.0;
+
+    bool supported = false;
+    bool enabled = true;
+
+    VkDevice device;
+
+    void Initialize(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t queueFamily, uint32_t frameCount)
+    {
+        GpuProfiler::device = device;
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+
+        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+        uint32_t validBits = queueFamily < queueFamilyCount ? queueFamilies[queueFamily].timestampValidBits : 0;
+
+        supported = validBits > 0 && properties.limits.timestampPeriod > 0.0f;
+
+        if (!supported)
+        {
+            if (enabled)
+                Logger_WriteConsole("Graphics queue does not support timestamps, GPU timings will not be measured", LogLevel::WARNING);
+
+            return;
+        }
+
+        timestampMask = validBits >= 64 ? UINT64_MAX : (1ull << validBits) - 1;
+        timestampPeriod = properties.limits.timestampPeriod;
+
+        queryPools.resize(frameCount);
+        frameScopes.resize(frameCount);
+
+        VkQueryPoolCreateInfo poolInformation = {};
+
+        poolInformation.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInformation.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        poolInformation.queryCount = MAX_GPU_SCOPES * 2;
+
+        for (auto& pool : queryPools)
+        {
+            if (vkCreateQueryPool(device, &poolInformation, VULKAN_ALLOCATOR, &pool) != VK_SUCCESS)
+                Logger_ThrowError("VK_FAILURE", "Failed to create timestamp query pool!", true);
+        }
+    }
+
+    bool Active()
+    {
+        return supported && enabled;
+    }
+
+    void Collect(size_t frame)
+    {
+        if (!Active() || frameScopes[frame].empty())
+            return;
+
+        std::vector<GpuScope>& scopes = frameScopes[frame];
+        uint32_t queryCount = 0;
+
+        for (const auto& scope : scopes)
+            queryCount = std::max(queryCount, scope.endQuery + 1);
+
+        std::vector<uint64_t> timestamps(queryCount, 0);
+
+        VkResult result = vkGetQueryPoolResults(device, queryPools[frame], 0, queryCount, timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+        if (result == VK_SUCCESS)
+        {
+            for (const auto& scope : scopes)
+            {
+                uint64_t begin = timestamps[scope.beginQuery] & timestampMask;
+                uint64_t end = timestamps[scope.endQuery] & timestampMask;
+
+                if (end < begin)
+                    continue;
+
+                auto [entry, inserted] = history.try_emplace(scope.name);
+
+                if (inserted)
+                    scopeOrder.push_back(scope.name);
+
+                entry->second.depth = scope.depth;
+                entry->second.Add((double)(end - begin) * timestampPeriod / 1000000.0);
+            }
+        }
+
+        scopes.clear();
+    }
+
+    // Recorded outside any render pass, query resets are not allowed inside one
+    void Reset(VkCommandBuffer commandBuffer, size_t frame)
+    {
+        currentFrame = static_cast<uint32_t>(frame);
+        nextQuery = 0;
+        openScopes.clear();
+        counterScopes.clear();
+
+        if (Active())
+            vkCmdResetQueryPool(commandBuffer, queryPools[frame], 0, MAX_GPU_SCOPES * 2);
+    }
+
+    // Statistics and vendor counter queries can't nest, so only the innermost scopes (the render graph's passes) ask for them
+    void BeginScope(VkCommandBuffer commandBuffer, const std::string& name, bool counters = false)
+    {
+        if (counters)
+        {
+            PipelineStatistics::BeginScope(commandBuffer, name);
+            PerformanceCounters::BeginScope(commandBuffer, name);
+        }
+
+        counterScopes.push_back(counters);
+
+        if (!Active())
+            return;
+
+        // Past the cap the scope still has to be matched by its EndScope, or it would close the enclosing one
+        if (nextQuery + 2 > MAX_GPU_SCOPES * 2)
+        {
+            openScopes.push_back(GPU_SCOPE_DROPPED);
+            return;
+        }
+
+        std::vector<GpuScope>& scopes = frameScopes[currentFrame];
+
+        GpuScope& scope = scopes.emplace_back();
+
+        scope.name = name;
+        scope.depth = static_cast<uint32_t>(openScopes.size());
+        scope.beginQuery = nextQuery++;
+        scope.endQuery = nextQuery++;
+
+        openScopes.push_back(static_cast<uint32_t>(scopes.size() - 1));
+
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPools[currentFrame], scope.beginQuery);
+    }
+
+    void EndScope(VkCommandBuffer commandBuffer)
+    {
+        if (!counterScopes.empty())
+        {
+            if (counterScopes.back())
+            {
+                PerformanceCounters::EndScope(commandBuffer);
+                PipelineStatistics::EndScope(commandBuffer);
+            }
+
+            counterScopes.pop_back();
+        }
+
+        if (!Active() || openScopes.empty())
+            return;
+
+        uint32_t index = openScopes.back();
+        openScopes.pop_back();
+
+        if (index == GPU_SCOPE_DROPPED)
+            return;
+
+        const GpuScope& scope = frameScopes[currentFrame][index];
+
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPools[currentFrame], scope.endQuery);
+    }
+
+    GpuScopeStatistics GetStatistics(const std::string& name)
+    {
+        auto found = history.find(name);
+
+        return found != history.end() ? found->second.GetStatistics() : GpuScopeStatistics{};
+    }
+
+    PipelineCounterHistory GetCounters(const std::string& name)
+    {
+        return PipelineStatistics::GetCounters(name);
+    }
+
+    PerformanceCounterHistory GetPerformanceCounters(const std::string& name)
+    {
+        return PerformanceCounters::GetCounters(name);
+    }
+
+    void LogSummary()
+    {
+        if (!Active() || scopeOrder.empty())
+            return;
+
+        for (const auto& name : scopeOrder)
+        {
+            const GpuScopeHistory& scope = history[name];
+            GpuScopeStatistics statistics = scope.GetStatistics();
+
+            Logger_WriteConsole(std::format("GPU {}{}: {:.3f} ms average, p50 {:.3f}, p95 {:.3f}, p99 {:.3f} over {} frames", std::string(scope.depth * 2, ' '), name,
+                statistics.average, statistics.p50, statistics.p95, statistics.p99, statistics.samples), LogLevel::INFO);
+        }
+    }
+
+    void CleanUp()
+    {
+        for (VkQueryPool pool : queryPools)
+            vkDestroyQueryPool(device, pool, VULKAN_ALLOCATOR);
+
+        queryPools.clear();
+        frameScopes.clear();
+        openScopes.clear();
+        counterScopes.clear();
+    }
+}
+
+#endif // !GPU_PROFILER_HPP
@@ -0,0 +1,329 @@
+#ifndef IMAGE_CACHE_HPP
+#define IMAGE_CACHE_HPP
+
+#include <mutex>
+#include <vector>
+#include <format>
+#include <algorithm>
+#include <unordered_map>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core/AllocationTracker.hpp"
+#include "core/Logger.hpp"
+#include "util/Hash.hpp"
+
+template<typename T, typename Information>
+struct CachedObject
+{
+    T handle = VK_NULL_HANDLE;
+    Information information = {};
+
+    uint32_t references = 0;
+    uint32_t idleFrames = 0;
+};
+
+namespace ImageCache
+{
+    std::unordered_map<uint64_t, CachedObject<VkSampler, VkSamplerCreateInfo>> samplers;
+    std::unordered_map<uint64_t, CachedObject<VkImageView, VkImageViewCreateInfo>> imageViews;
+    std::unordered_map<VkSampler, uint64_t> samplerKeys;
+    std::unordered_map<VkImageView, uint64_t> imageViewKeys;
+    std::unordered_map<VkImageView, VkImage> imageViewSources;
+
+    std::vector<uint64_t> retiredSamplers;
+    std::vector<uint64_t> retiredImageViews;
+
+    std::mutex mutex;
+    VkDevice device;
+    uint32_t framesInFlight = 1;
+    uint32_t maxSamplers = 4000;
+
+    void Initialize(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t frames)
+    {
+        ImageCache::device = device;
+        framesInFlight = frames;
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+        maxSamplers = properties.limits.maxSamplerAllocationCount;
+    }
+
+    // Chained structures (pNext) are not part of the key, so they must not be used with cached objects
+    uint64_t HashSampler(const VkSamplerCreateInfo& information)
+    {
+        uint64_t hash = HASH_FNV_OFFSET;
+
+        hash = Hash::Combine(hash, information.flags);
+        hash = Hash::Combine(hash, information.magFilter);
+        hash = Hash::Combine(hash, information.minFilter);
+        hash = Hash::Combine(hash, information.mipmapMode);
+        hash = Hash::Combine(hash, information.addressModeU);
+        hash = Hash::Combine(hash, information.addressModeV);
+        hash = Hash::Combine(hash, information.addressModeW);
+        hash = Hash::Combine(hash, information.mipLodBias);
+        hash = Hash::Combine(hash, information.anisotropyEnable);
+        hash = Hash::Combine(hash, information.maxAnisotropy);
+        hash = Hash::Combine(hash, information.compareEnable);
+        hash = Hash::Combine(hash, information.compareOp);
+        hash = Hash::Combine(hash, information.minLod);
+        hash = Hash::Combine(hash, information.maxLod);
+        hash = Hash::Combine(hash, information.borderColor);
+        hash = Hash::Combine(hash, information.unnormalizedCoordinates);
+
+        return hash;
+    }
+
+    uint64_t HashImageView(const VkImageViewCreateInfo& information)
+    {
+        uint64_t hash = HASH_FNV_OFFSET;
+
+        hash = Hash::Combine(hash, information.flags);
+        hash = Hash::Combine(hash, information.image);
+        hash = Hash::Combine(hash, information.viewType);
+        hash = Hash::Combine(hash, information.format);
+        hash = Hash::Combine(hash, information.components.r);
+        hash = Hash::Combine(hash, information.components.g);
+        hash = Hash::Combine(hash, information.components.b);
+        hash = Hash::Combine(hash, information.components.a);
+        hash = Hash::Combine(hash, information.subresourceRange.aspectMask);
+        hash = Hash::Combine(hash, information.subresourceRange.baseMipLevel);
+        hash = Hash::Combine(hash, information.subresourceRange.levelCount);
+        hash = Hash::Combine(hash, information.subresourceRange.baseArrayLayer);
+        hash = Hash::Combine(hash, information.subresourceRange.layerCount);
+
+        return hash;
+    }
+
+    bool Equal(const VkSamplerCreateInfo& a, const VkSamplerCreateInfo& b)
+    {
+        return a.flags == b.flags && a.magFilter == b.magFilter && a.minFilter == b.minFilter && a.mipmapMode == b.mipmapMode &&
+            a.addressModeU == b.addressModeU && a.addressModeV == b.addressModeV && a.addressModeW == b.addressModeW && a.mipLodBias == b.mipLodBias &&
+            a.anisotropyEnable == b.anisotropyEnable && a.maxAnisotropy == b.maxAnisotropy && a.compareEnable == b.compareEnable && a.compareOp == b.compareOp &&
+            a.minLod == b.minLod && a.maxLod == b.maxLod && a.borderColor == b.borderColor && a.unnormalizedCoordinates == b.unnormalizedCoordinates;
+    }
+
+    bool Equal(const VkImageViewCreateInfo& a, const VkImageViewCreateInfo& b)
+    {
+        return a.flags == b.flags && a.image == b.image && a.viewType == b.viewType && a.format == b.format &&
+            a.components.r == b.components.r && a.components.g == b.components.g && a.components.b == b.components.b && a.components.a == b.components.a &&
+            a.subresourceRange.aspectMask == b.subresourceRange.aspectMask && a.subresourceRange.baseMipLevel == b.subresourceRange.baseMipLevel &&
+            a.subresourceRange.levelCount == b.subresourceRange.levelCount && a.subresourceRange.baseArrayLayer == b.subresourceRange.baseArrayLayer &&
+            a.subresourceRange.layerCount == b.subresourceRange.layerCount;
+    }
+
+    // Colliding create infos move on to the next free key, so a hit is only returned when the stored create info matches
+    template<typename T, typename Information>
+    typename std::unordered_map<uint64_t, CachedObject<T, Information>>::iterator Find(std::unordered_map<uint64_t, CachedObject<T, Information>>& objects, const Information& information, uint64_t& key)
+    {
+        auto found = objects.find(key);
+
+        while (found != objects.end() && !Equal(found->second.information, information))
+            found = objects.find(++key);
+
+        return found;
+    }
+
+    VkSampler AcquireSampler(const VkSamplerCreateInfo& information)
+    {
+        uint64_t hash = HashSampler(information);
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto found = Find(samplers, information, hash);
+
+        if (found != samplers.end())
+        {
+            found->second.references++;
+            found->second.idleFrames = 0;
+
+            return found->second.handle;
+        }
+
+        if (samplers.size() >= maxSamplers)
+            Logger_ThrowError("VK_FAILURE", std::format("Sampler count would exceed the device limit of {}", maxSamplers), true);
+
+        VkSampler sampler = VK_NULL_HANDLE;
+
+        if (vkCreateSampler(device, &information, VULKAN_ALLOCATOR, &sampler) != VK_SUCCESS)
+            Logger_ThrowError("VK_FAILURE", "Failed to create sampler!", true);
+
+        VkSamplerCreateInfo stored = information;
+        stored.pNext = nullptr;
+
+        samplers.insert({ hash, { sampler, stored, 1 } });
+        samplerKeys.insert({ sampler, hash });
+
+        return sampler;
+    }
+
+    VkImageView AcquireImageView(const VkImageViewCreateInfo& information)
+    {
+        uint64_t hash = HashImageView(information);
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto found = Find(imageViews, information, hash);
+
+        if (found != imageViews.end())
+        {
+            found->second.references++;
+            found->second.idleFrames = 0;
+
+            return found->second.handle;
+        }
+
+        VkImageView view = VK_NULL_HANDLE;
+
+        if (vkCreateImageView(device, &information, VULKAN_ALLOCATOR, &view) != VK_SUCCESS)
+            Logger_ThrowError("VK_FAILURE", "Failed to create image view!", true);
+
+        VkImageViewCreateInfo stored = information;
+        stored.pNext = nullptr;
+
+        imageViews.insert({ hash, { view, stored, 1 } });
+        imageViewKeys.insert({ view, hash });
+        imageViewSources.insert({ view, information.image });
+
+        return view;
+    }
+
+    // Unreferenced objects stay cached for a full round of frames in flight before they are destroyed, so streaming can pick them back up
+    template<typename T, typename Information>
+    void Release(T handle, std::unordered_map<uint64_t, CachedObject<T, Information>>& objects, std::unordered_map<T, uint64_t>& keys, std::vector<uint64_t>& retired)
+    {
+        if (handle == VK_NULL_HANDLE)
+            return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto key = keys.find(handle);
+
+        if (key == keys.end())
+        {
+            Logger_WriteConsole("Released an object that is not owned by the image cache", LogLevel::WARNING);
+            return;
+        }
+
+        CachedObject<T, Information>& object = objects[key->second];
+
+        if (object.references == 0)
+            return;
+
+        if (--object.references == 0)
+        {
+            object.idleFrames = 0;
+
+            if (std::find(retired.begin(), retired.end(), key->second) == retired.end())
+                retired.push_back(key->second);
+        }
+    }
+
+    void ReleaseSampler(VkSampler sampler)
+    {
+        Release(sampler, samplers, samplerKeys, retiredSamplers);
+    }
+
+    void ReleaseImageView(VkImageView view)
+    {
+        Release(view, imageViews, imageViewKeys, retiredImageViews);
+    }
+
+    void DestroyImageView(uint64_t hash)
+    {
+        VkImageView view = imageViews[hash].handle;
+
+        vkDestroyImageView(device, view, VULKAN_ALLOCATOR);
+
+        imageViewKeys.erase(view);
+        imageViewSources.erase(view);
+        imageViews.erase(hash);
+    }
+
+    void DestroyImageViews(VkImage image)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::vector<uint64_t> destroyed;
+
+        for (auto& [view, source] : imageViewSources)
+        {
+            if (source == image)
+                destroyed.push_back(imageViewKeys[view]);
+        }
+
+        for (uint64_t hash : destroyed)
+            DestroyImageView(hash);
+
+        std::erase_if(retiredImageViews, [](uint64_t hash) { return !imageViews.contains(hash); });
+    }
+
+    void BeginFrame()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::erase_if(retiredSamplers, [](uint64_t hash)
+        {
+            CachedObject<VkSampler, VkSamplerCreateInfo>& sampler = samplers.at(hash);
+
+            if (sampler.references > 0)
+                return true;
+
+            if (++sampler.idleFrames <= framesInFlight)
+                return false;
+
+            vkDestroySampler(device, sampler.handle, VULKAN_ALLOCATOR);
+
+            samplerKeys.erase(sampler.handle);
+            samplers.erase(hash);
+
+            return true;
+        });
+
+        std::erase_if(retiredImageViews, [](uint64_t hash)
+        {
+            CachedObject<VkImageView, VkImageViewCreateInfo>& view = imageViews.at(hash);
+
+            if (view.references > 0)
+                return true;
+
+            if (++view.idleFrames <= framesInFlight)
+                return false;
+
+            DestroyImageView(hash);
+
+            return true;
+        });
+    }
+
+    void CleanUp()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+#ifdef _DEBUG
+        size_t leaked = std::count_if(samplers.begin(), samplers.end(), [](const auto& entry) { return entry.second.references > 0; }) +
+            std::count_if(imageViews.begin(), imageViews.end(), [](const auto& entry) { return entry.second.references > 0; });
+
+        if (leaked > 0)
+            Logger_WriteConsole(std::format("{} cached samplers and image views were never released", leaked), LogLevel::WARNING);
+#endif
+
+        for (auto& [hash, sampler] : samplers)
+            vkDestroySampler(device, sampler.handle, VULKAN_ALLOCATOR);
+
+        for (auto& [hash, view] : imageViews)
+            vkDestroyImageView(device, view.handle, VULKAN_ALLOCATOR);
+
+        samplers.clear();
+        imageViews.clear();
+        samplerKeys.clear();
+        imageViewKeys.clear();
+        imageViewSources.clear();
+        retiredSamplers.clear();
+        retiredImageViews.clear();
+    }
+}
+
+#endif // !IMAGE_CACHE_HPP
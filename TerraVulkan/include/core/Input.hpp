@@ -0,0 +1,277 @@
+#ifndef INPUT_HPP
+#define INPUT_HPP
+
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <format>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+#include "core/Logger.hpp"
+#include "core/Window.hpp"
+#include "thread/SpscQueue.hpp"
+#include "util/GL.hpp"
+
+#define INPUT_QUEUE_SIZE 1024
+#define INPUT_KEY_COUNT (GLFW_KEY_LAST + 1)
+#define INPUT_MOUSE_BUTTON_COUNT (GLFW_MOUSE_BUTTON_LAST + 1)
+#define INPUT_MAX_GAMEPADS 4
+
+enum class InputEventType : uint8_t
+{
+    KEY,
+    MOUSE_BUTTON,
+    CURSOR,
+    SCROLL,
+    RESIZE,
+    GAMEPAD
+};
+
+struct GamepadState
+{
+    bool connected = false;
+
+    std::array<uint8_t, GLFW_GAMEPAD_BUTTON_LAST + 1> buttons = {};
+    std::array<float, GLFW_GAMEPAD_AXIS_LAST + 1> axes = {};
+
+    bool operator==(const GamepadState& other) const = default;
+};
+
+struct InputEvent
+{
+    InputEventType type = InputEventType::KEY;
+    uint64_t timestamp = 0;
+
+    int32_t code = 0;
+    int32_t action = 0;
+    int32_t mods = 0;
+
+    glm::dvec2 value = {};
+    GamepadState gamepad = {};
+};
+
+struct InputSnapshot
+{
+    std::bitset<INPUT_KEY_COUNT> keys = {};
+    std::bitset<INPUT_KEY_COUNT> keysPressed = {};
+    std::bitset<INPUT_KEY_COUNT> keysReleased = {};
+
+    std::bitset<INPUT_MOUSE_BUTTON_COUNT> buttons = {};
+    std::bitset<INPUT_MOUSE_BUTTON_COUNT> buttonsPressed = {};
+    std::bitset<INPUT_MOUSE_BUTTON_COUNT> buttonsReleased = {};
+
+    glm::dvec2 cursor = {};
+    glm::dvec2 cursorDelta = {};
+    bool cursorKnown = false;
+    glm::dvec2 scroll = {};
+
+    std::array<GamepadState, INPUT_MAX_GAMEPADS> gamepads = {};
+
+    glm::ivec2 framebufferSize = {};
+    bool resized = false;
+
+    uint32_t events = 0;
+    float maxLatency = 0.0f;
+
+    bool IsDown(int key) const
+    {
+        return key >= 0 && key < INPUT_KEY_COUNT && keys[key];
+    }
+
+    bool WasPressed(int key) const
+    {
+        return key >= 0 && key < INPUT_KEY_COUNT && keysPressed[key];
+    }
+
+    bool WasReleased(int key) const
+    {
+        return key >= 0 && key < INPUT_KEY_COUNT && keysReleased[key];
+    }
+
+    bool IsButtonDown(int button) const
+    {
+        return button >= 0 && button < INPUT_MOUSE_BUTTON_COUNT && buttons[button];
+    }
+};
+
+namespace Input
+{
+    SpscQueue<InputEvent, INPUT_QUEUE_SIZE> events;
+
+    std::array<GamepadState, INPUT_MAX_GAMEPADS> lastGamepads = {};
+    uint64_t lastResizeCount = 0;
+
+    std::atomic<uint64_t> droppedEvents = 0;
+
+    uint64_t consumedEvents = 0;
+    double totalLatency = 0.0;
+    float maxLatency = 0.0f;
+
+    uint64_t Now()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void Push(InputEvent event)
+    {
+        event.timestamp = Now();
+
+        if (!events.Push(event))
+            droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Initialize()
+    {
+        GL_WINDOW_SET_KEY_CALLBACK(Window::window, [](GLFWwindow* window, int key, int scancode, int action, int mods)
+        {
+            if (action != GLFW_REPEAT)
+                Push({ InputEventType::KEY, 0, key, action, mods });
+        });
+
+        GL_WINDOW_SET_MOUSE_BUTTON_CALLBACK(Window::window, [](GLFWwindow* window, int button, int action, int mods)
+        {
+            Push({ InputEventType::MOUSE_BUTTON, 0, button, action, mods });
+        });
+
+        GL_WINDOW_SET_CURSOR_POS_CALLBACK(Window::window, [](GLFWwindow* window, double x, double y)
+        {
+            Push({ InputEventType::CURSOR, 0, 0, 0, 0, { x, y } });
+        });
+
+        GL_WINDOW_SET_SCROLL_CALLBACK(Window::window, [](GLFWwindow* window, double x, double y)
+        {
+            Push({ InputEventType::SCROLL, 0, 0, 0, 0, { x, y } });
+        });
+
+        lastResizeCount = Window::resizeCount;
+    }
+
+    void Update()
+    {
+        if (Window::resizeCount != lastResizeCount)
+        {
+            lastResizeCount = Window::resizeCount;
+
+            Push({ InputEventType::RESIZE, 0, 0, 0, 0, glm::dvec2(Window::framebufferSize) });
+        }
+
+        for (int joystick = 0; joystick < INPUT_MAX_GAMEPADS; joystick++)
+        {
+            GamepadState state = {};
+            GLFWgamepadstate raw = {};
+
+            if (GL_WINDOW_JOYSTICK_IS_GAMEPAD(GLFW_JOYSTICK_1 + joystick) && GL_WINDOW_GET_GAMEPAD_STATE(GLFW_JOYSTICK_1 + joystick, &raw))
+            {
+                state.connected = true;
+
+                std::copy(std::begin(raw.buttons), std::end(raw.buttons), state.buttons.begin());
+                std::copy(std::begin(raw.axes), std::end(raw.axes), state.axes.begin());
+            }
+
+            if (state == lastGamepads[joystick])
+                continue;
+
+            lastGamepads[joystick] = state;
+
+            InputEvent event = { InputEventType::GAMEPAD, 0, joystick };
+            event.gamepad = state;
+
+            Push(event);
+        }
+    }
+
+    void Apply(InputSnapshot& snapshot, const InputEvent& event)
+    {
+        switch (event.type)
+        {
+        case InputEventType::KEY:
+            if (event.code < 0 || event.code >= INPUT_KEY_COUNT)
+                break;
+
+            snapshot.keys[event.code] = event.action == GLFW_PRESS;
+
+            if (event.action == GLFW_PRESS)
+                snapshot.keysPressed[event.code] = true;
+            else
+                snapshot.keysReleased[event.code] = true;
+            break;
+
+        case InputEventType::MOUSE_BUTTON:
+            if (event.code < 0 || event.code >= INPUT_MOUSE_BUTTON_COUNT)
+                break;
+
+            snapshot.buttons[event.code] = event.action == GLFW_PRESS;
+
+            if (event.action == GLFW_PRESS)
+                snapshot.buttonsPressed[event.code] = true;
+            else
+                snapshot.buttonsReleased[event.code] = true;
+            break;
+
+        case InputEventType::CURSOR:
+            if (snapshot.cursorKnown)
+                snapshot.cursorDelta += event.value - snapshot.cursor;
+
+            snapshot.cursor = event.value;
+            snapshot.cursorKnown = true;
+            break;
+
+        case InputEventType::SCROLL:
+            snapshot.scroll += event.value;
+            break;
+
+        case InputEventType::RESIZE:
+            snapshot.framebufferSize = glm::ivec2(event.value);
+            snapshot.resized = true;
+            break;
+
+        case InputEventType::GAMEPAD:
+            if (event.code >= 0 && event.code < INPUT_MAX_GAMEPADS)
+                snapshot.gamepads[event.code] = event.gamepad;
+            break;
+        }
+    }
+
+    void Consume(InputSnapshot& snapshot)
+    {
+        snapshot.keysPressed.reset();
+        snapshot.keysReleased.reset();
+        snapshot.buttonsPressed.reset();
+        snapshot.buttonsReleased.reset();
+        snapshot.cursorDelta = {};
+        snapshot.scroll = {};
+        snapshot.resized = false;
+        snapshot.events = 0;
+        snapshot.maxLatency = 0.0f;
+
+        uint64_t now = Now();
+        InputEvent event;
+
+        while (events.Pop(event))
+        {
+            Apply(snapshot, event);
+
+            float latency = (now > event.timestamp ? now - event.timestamp : 0) / 1000000.0f;
+
+            snapshot.events++;
+            snapshot.maxLatency = std::max(snapshot.maxLatency, latency);
+
+            consumedEvents++;
+            totalLatency += latency;
+            maxLatency = std::max(maxLatency, latency);
+        }
+    }
+
+    void LogSummary()
+    {
+        if (consumedEvents == 0)
+            return;
+
+        Logger_WriteConsole(std::format("Input: {} events, {:.2f} ms average latency to consumption, {:.2f} ms worst, {} dropped", consumedEvents,
+            totalLatency / consumedEvents, maxLatency, droppedEvents.load(std::memory_order_relaxed)), LogLevel::INFO);
+    }
+}
+
+#endif // !INPUT_HPP
@@ -0,0 +1,207 @@
+#ifndef LAYOUT_CACHE_HPP
+#define LAYOUT_CACHE_HPP
+
+#include <vector>
+#include <mutex>
+#include <algorithm>
+#include <unordered_map>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core/AllocationTracker.hpp"
+#include "core/Logger.hpp"
+#include "render/ShaderReflection.hpp"
+#include "util/Hash.hpp"
+
+struct PipelineLayoutDescription
+{
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+
+    std::vector<VkDescriptorSetLayout> setLayouts = {};
+    VkPushConstantRange pushConstants = {};
+};
+
+struct CachedSetLayout
+{
+    std::vector<VkDescriptorSetLayoutBinding> bindings = {};
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+};
+
+namespace LayoutCache
+{
+    std::unordered_multimap<uint64_t, CachedSetLayout> setLayouts;
+    std::unordered_multimap<uint64_t, PipelineLayoutDescription> pipelineLayouts;
+    std::mutex mutex;
+    VkDevice device;
+
+    void Initialize(VkDevice device)
+    {
+        LayoutCache::device = device;
+    }
+
+    uint64_t HashBindings(const std::vector<VkDescriptorSetLayoutBinding>& bindings)
+    {
+        uint64_t hash = HASH_FNV_OFFSET;
+
+        for (const auto& binding : bindings)
+        {
+            hash = Hash::Combine(hash, binding.binding);
+            hash = Hash::Combine(hash, binding.descriptorType);
+            hash = Hash::Combine(hash, binding.descriptorCount);
+            hash = Hash::Combine(hash, binding.stageFlags);
+        }
+
+        return hash;
+    }
+
+    bool Equal(const std::vector<VkDescriptorSetLayoutBinding>& a, const std::vector<VkDescriptorSetLayoutBinding>& b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const VkDescriptorSetLayoutBinding& x, const VkDescriptorSetLayoutBinding& y)
+        {
+            return x.binding == y.binding && x.descriptorType == y.descriptorType && x.descriptorCount == y.descriptorCount && x.stageFlags == y.stageFlags;
+        });
+    }
+
+    bool Equal(const PipelineLayoutDescription& description, const std::vector<VkDescriptorSetLayout>& layouts, const VkPushConstantRange& pushConstants)
+    {
+        return description.setLayouts == layouts && description.pushConstants.stageFlags == pushConstants.stageFlags &&
+            description.pushConstants.offset == pushConstants.offset && description.pushConstants.size == pushConstants.size;
+    }
+
+    VkDescriptorSetLayout GetDescriptorSetLayout(std::vector<VkDescriptorSetLayoutBinding> bindings)
+    {
+        std::sort(bindings.begin(), bindings.end(), [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) { return a.binding < b.binding; });
+
+        uint64_t hash = HashBindings(bindings);
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto [first, last] = setLayouts.equal_range(hash);
+
+        for (auto found = first; found != last; found++)
+        {
+            if (Equal(found->second.bindings, bindings))
+                return found->second.layout;
+        }
+
+        VkDescriptorSetLayoutCreateInfo creationInformation = {};
+
+        creationInformation.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        creationInformation.bindingCount = static_cast<uint32_t>(bindings.size());
+        creationInformation.pBindings = bindings.data();
+
+        VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+
+        if (vkCreateDescriptorSetLayout(device, &creationInformation, VULKAN_ALLOCATOR, &layout) != VK_SUCCESS)
+            Logger_ThrowError("VK_FAILURE", "Failed to create descriptor set layout!", true);
+
+        setLayouts.insert({ hash, { bindings, layout } });
+
+        return layout;
+    }
+
+    const PipelineLayoutDescription& GetPipelineLayout(const std::vector<VkDescriptorSetLayout>& layouts, const VkPushConstantRange& pushConstants)
+    {
+        uint64_t hash = HASH_FNV_OFFSET;
+
+        for (VkDescriptorSetLayout layout : layouts)
+            hash = Hash::Combine(hash, layout);
+
+        hash = Hash::Combine(hash, pushConstants.stageFlags);
+        hash = Hash::Combine(hash, pushConstants.offset);
+        hash = Hash::Combine(hash, pushConstants.size);
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto [first, last] = pipelineLayouts.equal_range(hash);
+
+        for (auto found = first; found != last; found++)
+        {
+            if (Equal(found->second, layouts, pushConstants))
+                return found->second;
+        }
+
+        PipelineLayoutDescription description = {};
+
+        description.setLayouts = layouts;
+        description.pushConstants = pushConstants;
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(layouts.size());
+        pipelineLayoutInfo.pSetLayouts = layouts.data();
+        pipelineLayoutInfo.pushConstantRangeCount = pushConstants.size > 0 ? 1 : 0;
+        pipelineLayoutInfo.pPushConstantRanges = &description.pushConstants;
+
+        if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, VULKAN_ALLOCATOR, &description.layout) != VK_SUCCESS)
+            Logger_ThrowError("VK_FAILURE", "Failed to create pipeline layout!", true);
+
+        return pipelineLayouts.insert({ hash, description }).first->second;
+    }
+
+    const PipelineLayoutDescription& GetPipelineLayout(const std::vector<const ShaderReflection*>& stages)
+    {
+        std::vector<std::vector<VkDescriptorSetLayoutBinding>> sets;
+        std::vector<VkDescriptorType> types;
+        VkPushConstantRange pushConstants = {};
+
+        for (const ShaderReflection* stage : stages)
+        {
+            for (const ShaderBinding& binding : stage->bindings)
+            {
+                if (sets.size() <= binding.set)
+                    sets.resize(binding.set + 1);
+
+                auto& set = sets[binding.set];
+                auto existing = std::find_if(set.begin(), set.end(), [&](const VkDescriptorSetLayoutBinding& other) { return other.binding == binding.binding; });
+
+                if (existing == set.end())
+                {
+                    VkDescriptorSetLayoutBinding layoutBinding = {};
+
+                    layoutBinding.binding = binding.binding;
+                    layoutBinding.descriptorType = binding.type;
+                    layoutBinding.descriptorCount = binding.count;
+                    layoutBinding.stageFlags = stage->stage;
+
+                    set.push_back(layoutBinding);
+                }
+                else if (existing->descriptorType != binding.type || existing->descriptorCount != binding.count)
+                    Logger_ThrowError("SPIR-V", std::format("Shader stages disagree on the descriptor at set {}, binding {}", binding.set, binding.binding), true);
+                else
+                    existing->stageFlags |= stage->stage;
+            }
+
+            if (stage->pushConstantSize > 0)
+            {
+                pushConstants.stageFlags |= stage->stage;
+                pushConstants.size = std::max(pushConstants.size, stage->pushConstantSize);
+            }
+        }
+
+        std::vector<VkDescriptorSetLayout> layouts;
+
+        for (const auto& set : sets)
+            layouts.push_back(GetDescriptorSetLayout(set));
+
+        return GetPipelineLayout(layouts, pushConstants);
+    }
+
+    void CleanUp()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (auto& [hash, description] : pipelineLayouts)
+            vkDestroyPipelineLayout(device, description.layout, VULKAN_ALLOCATOR);
+
+        for (auto& [hash, cached] : setLayouts)
+            vkDestroyDescriptorSetLayout(device, cached.layout, VULKAN_ALLOCATOR);
+
+        pipelineLayouts.clear();
+        setLayouts.clear();
+    }
+}
+
+#endif // !LAYOUT_CACHE_HPP
@@ -0,0 +1,179 @@
+#ifndef LOOP_CONTROLLER_HPP
+#define LOOP_CONTROLLER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+
+#include "core/Logger.hpp"
+#include "core/Window.hpp"
+#include "util/GL.hpp"
+
+#define LOOP_IDLE_TIMEOUT 0.25
+#define LOOP_UNFOCUSED_FPS 10.0
+
+namespace LoopController
+{
+    double targetFps = 0.0;
+    double unfocusedFps = LOOP_UNFOCUSED_FPS;
+    bool throttleUnfocused = true;
+
+    bool renderOnDemand = false;
+
+    std::atomic<bool> iconified = false;
+    std::atomic<bool> focused = true;
+    std::atomic<bool> redrawRequested = true;
+
+    std::chrono::steady_clock::time_point nextFrame = {};
+
+    double sleepMean = 0.002;
+    double sleepM2 = 0.0;
+    uint64_t sleepCount = 1;
+
+#ifdef _WIN32
+    HANDLE timer = nullptr;
+#endif
+
+    void RequestRedraw()
+    {
+        redrawRequested.store(true, std::memory_order_release);
+        GL_POST_EMPTY_EVENT();
+    }
+
+    void Initialize()
+    {
+#ifdef _WIN32
+        // Plain Sleep rounds up to the 15.6 ms scheduler tick, a high resolution timer gets within a fraction of a millisecond
+        timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+
+        focused = GL_WINDOW_GET_ATTRIBUTE(Window::window, GLFW_FOCUSED) == GLFW_TRUE;
+        iconified = GL_WINDOW_GET_ATTRIBUTE(Window::window, GLFW_ICONIFIED) == GLFW_TRUE;
+
+        GL_WINDOW_SET_ICONIFY_CALLBACK(Window::window, [](GLFWwindow* window, int value)
+        {
+            iconified = value == GLFW_TRUE;
+            redrawRequested = true;
+        });
+
+        GL_WINDOW_SET_FOCUS_CALLBACK(Window::window, [](GLFWwindow* window, int value)
+        {
+            focused = value == GLFW_TRUE;
+            redrawRequested = true;
+        });
+
+        GL_WINDOW_SET_REFRESH_CALLBACK(Window::window, [](GLFWwindow* window)
+        {
+            redrawRequested = true;
+        });
+
+        nextFrame = std::chrono::steady_clock::now();
+    }
+
+    void SleepFor(double seconds)
+    {
+#ifdef _WIN32
+        if (timer != nullptr)
+        {
+            LARGE_INTEGER dueTime = {};
+            dueTime.QuadPart = -(LONGLONG)(seconds * 10000000.0);
+
+            if (SetWaitableTimerEx(timer, &dueTime, 0, nullptr, nullptr, nullptr, 0))
+            {
+                WaitForSingleObject(timer, INFINITE);
+                return;
+            }
+        }
+#endif
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    }
+
+    void WaitUntil(std::chrono::steady_clock::time_point deadline)
+    {
+        using Seconds = std::chrono::duration<double>;
+
+        double remaining = Seconds(deadline - std::chrono::steady_clock::now()).count();
+
+        while (remaining > sleepMean + std::sqrt(sleepM2 / sleepCount))
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            SleepFor(0.001);
+
+            double observed = Seconds(std::chrono::steady_clock::now() - start).count();
+
+            remaining -= observed;
+
+            sleepCount++;
+            double delta = observed - sleepMean;
+            sleepMean += delta / sleepCount;
+            sleepM2 += delta * (observed - sleepMean);
+        }
+
+        while (std::chrono::steady_clock::now() < deadline)
+            std::this_thread::yield();
+    }
+
+    bool BeginFrame()
+    {
+        if (iconified)
+        {
+            GL_WAIT_EVENTS_TIMEOUT(LOOP_IDLE_TIMEOUT);
+            return false;
+        }
+
+        if (renderOnDemand)
+        {
+            if (!redrawRequested.load(std::memory_order_acquire))
+                GL_WAIT_EVENTS_TIMEOUT(LOOP_IDLE_TIMEOUT);
+            else
+                GL_POLL_EVENTS();
+
+            return redrawRequested.exchange(false, std::memory_order_acq_rel) && !iconified;
+        }
+
+        if (!focused && throttleUnfocused)
+        {
+            GL_WAIT_EVENTS_TIMEOUT(1.0 / std::max(unfocusedFps, 1.0));
+            return !iconified;
+        }
+
+        GL_POLL_EVENTS();
+
+        return true;
+    }
+
+    // A frame that ran long starts a fresh schedule instead of being followed by a burst of catch-up frames
+    void EndFrame()
+    {
+        if (targetFps <= 0.0 || renderOnDemand || !focused)
+            return;
+
+        auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / targetFps));
+        auto now = std::chrono::steady_clock::now();
+
+        nextFrame += period;
+
+        if (nextFrame < now)
+        {
+            nextFrame = now;
+            return;
+        }
+
+        WaitUntil(nextFrame);
+    }
+
+    void CleanUp()
+    {
+#ifdef _WIN32
+        if (timer != nullptr)
+            CloseHandle(timer);
+
+        timer = nullptr;
+#endif
+    }
+}
+
+#endif // !LOOP_CONTROLLER_HPP
@@ -0,0 +1,386 @@
+#ifndef PERFORMANCE_COUNTERS_HPP
+#define PERFORMANCE_COUNTERS_HPP
+
+#include <string>
+#include <vector>
+#include <format>
+#include <unordered_map>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core/AllocationTracker.hpp"
+#include "core/Logger.hpp"
+
+#define MAX_PERFORMANCE_COUNTERS 8
+#define MAX_PERFORMANCE_SCOPES 32
+
+struct PerformanceCounter
+{
+    std::string name = "";
+    uint32_t index = 0;
+
+    VkPerformanceCounterUnitKHR unit = VK_PERFORMANCE_COUNTER_UNIT_GENERIC_KHR;
+    VkPerformanceCounterStorageKHR storage = VK_PERFORMANCE_COUNTER_STORAGE_UINT64_KHR;
+};
+
+struct PerformanceCounterHistory
+{
+    std::vector<double> last = {};
+    std::vector<double> total = {};
+    uint64_t samples = 0;
+};
+
+struct PerformanceCounterScope
+{
+    std::string name = "";
+    uint32_t query = 0;
+};
+
+namespace PerformanceCounters
+{
+    std::vector<std::string> requested = {};
+
+    std::vector<PerformanceCounter> counters;
+    std::vector<VkQueryPool> queryPools;
+    std::vector<std::vector<PerformanceCounterScope>> frameScopes;
+
+    std::unordered_map<std::string, PerformanceCounterHistory> history;
+    std::vector<std::string> scopeOrder;
+
+    uint32_t currentFrame = 0;
+    uint32_t queueFamily = 0;
+    bool scopeOpen = false;
+    bool locked = false;
+
+    bool supported = false;
+    bool enabled = false;
+
+    VkDevice device;
+
+    PFN_vkAcquireProfilingLockKHR acquireProfilingLock = nullptr;
+    PFN_vkReleaseProfilingLockKHR releaseProfilingLock = nullptr;
+
+    VkPerformanceQuerySubmitInfoKHR submitInformation = { VK_STRUCTURE_TYPE_PERFORMANCE_QUERY_SUBMIT_INFO_KHR, nullptr, 0 };
+
+    bool IsRequested(const std::string& name)
+    {
+        if (requested.empty())
+            return true;
+
+        for (const auto& entry : requested)
+        {
+            if (name.find(entry) != std::string::npos)
+                return true;
+        }
+
+        return false;
+    }
+
+    // Host query reset is needed too, a performance query may not be reset in the command buffer that begins it
+    bool Select(VkInstance instance, VkPhysicalDevice physicalDevice, uint32_t queueFamily)
+    {
+        counters.clear();
+        supported = false;
+
+        if (!enabled)
+            return false;
+
+        VkPhysicalDeviceHostQueryResetFeatures hostQueryResetFeatures = {};
+        hostQueryResetFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES;
+
+        VkPhysicalDevicePerformanceQueryFeaturesKHR performanceQueryFeatures = {};
+        performanceQueryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PERFORMANCE_QUERY_FEATURES_KHR;
+        performanceQueryFeatures.pNext = &hostQueryResetFeatures;
+
+        VkPhysicalDeviceFeatures2 features = {};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &performanceQueryFeatures;
+
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+        auto enumerateCounters = (PFN_vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR)vkGetInstanceProcAddr(instance, "vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR");
+        auto getPassCount = (PFN_vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR)vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR");
+
+        if (!performanceQueryFeatures.performanceCounterQueryPools || !hostQueryResetFeatures.hostQueryReset || enumerateCounters == nullptr || getPassCount == nullptr)
+        {
+            Logger_WriteConsole("Device does not support performance queries, vendor counters will not be collected", LogLevel::WARNING);
+            return false;
+        }
+
+        uint32_t counterCount = 0;
+        enumerateCounters(physicalDevice, queueFamily, &counterCount, nullptr, nullptr);
+
+        std::vector<VkPerformanceCounterKHR> available(counterCount, { VK_STRUCTURE_TYPE_PERFORMANCE_COUNTER_KHR });
+        std::vector<VkPerformanceCounterDescriptionKHR> descriptions(counterCount, { VK_STRUCTURE_TYPE_PERFORMANCE_COUNTER_DESCRIPTION_KHR });
+
+        enumerateCounters(physicalDevice, queueFamily, &counterCount, available.data(), descriptions.data());
+
+        for (uint32_t i = 0; i < counterCount && counters.size() < MAX_PERFORMANCE_COUNTERS; i++)
+        {
+            if (available[i].scope != VK_PERFORMANCE_COUNTER_SCOPE_COMMAND_KHR || !IsRequested(descriptions[i].name))
+                continue;
+
+            counters.push_back({ descriptions[i].name, i, available[i].unit, available[i].storage });
+
+            std::vector<uint32_t> indices;
+
+            for (const auto& counter : counters)
+                indices.push_back(counter.index);
+
+            VkQueryPoolPerformanceCreateInfoKHR performanceInformation = {};
+
+            performanceInformation.sType = VK_STRUCTURE_TYPE_QUERY_POOL_PERFORMANCE_CREATE_INFO_KHR;
+            performanceInformation.queueFamilyIndex = queueFamily;
+            performanceInformation.counterIndexCount = static_cast<uint32_t>(indices.size());
+            performanceInformation.pCounterIndices = indices.data();
+
+            uint32_t passes = 0;
+            getPassCount(physicalDevice, &performanceInformation, &passes);
+
+            if (passes != 1)
+                counters.pop_back();
+        }
+
+        if (counters.empty())
+        {
+            Logger_WriteConsole("No command-scoped performance counters fit in a single pass, vendor counters will not be collected", LogLevel::WARNING);
+            return false;
+        }
+
+        PerformanceCounters::queueFamily = queueFamily;
+        supported = true;
+
+        return true;
+    }
+
+    void Initialize(VkDevice device, uint32_t frameCount)
+    {
+        PerformanceCounters::device = device;
+
+        if (!supported)
+            return;
+
+        acquireProfilingLock = (PFN_vkAcquireProfilingLockKHR)vkGetDeviceProcAddr(device, "vkAcquireProfilingLockKHR");
+        releaseProfilingLock = (PFN_vkReleaseProfilingLockKHR)vkGetDeviceProcAddr(device, "vkReleaseProfilingLockKHR");
+
+        VkAcquireProfilingLockInfoKHR lockInformation = {};
+
+        lockInformation.sType = VK_STRUCTURE_TYPE_ACQUIRE_PROFILING_LOCK_INFO_KHR;
+        lockInformation.timeout = UINT64_MAX;
+
+        // Held for the device's lifetime, it has to be taken before any command buffer using the queries starts recording
+        if (acquireProfilingLock == nullptr || releaseProfilingLock == nullptr || acquireProfilingLock(device, &lockInformation) != VK_SUCCESS)
+        {
+            Logger_WriteConsole("Could not acquire the profiling lock, vendor counters will not be collected", LogLevel::WARNING);
+
+            supported = false;
+            return;
+        }
+
+        locked = true;
+
+        std::vector<uint32_t> indices;
+
+        for (const auto& counter : counters)
+            indices.push_back(counter.index);
+
+        VkQueryPoolPerformanceCreateInfoKHR performanceInformation = {};
+
+        performanceInformation.sType = VK_STRUCTURE_TYPE_QUERY_POOL_PERFORMANCE_CREATE_INFO_KHR;
+        performanceInformation.queueFamilyIndex = queueFamily;
+        performanceInformation.counterIndexCount = static_cast<uint32_t>(indices.size());
+        performanceInformation.pCounterIndices = indices.data();
+
+        VkQueryPoolCreateInfo poolInformation = {};
+
+        poolInformation.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInformation.pNext = &performanceInformation;
+        poolInformation.queryType = VK_QUERY_TYPE_PERFORMANCE_QUERY_KHR;
+        poolInformation.queryCount = MAX_PERFORMANCE_SCOPES;
+
+        queryPools.resize(frameCount);
+        frameScopes.resize(frameCount);
+
+        for (auto& pool : queryPools)
+        {
+            if (vkCreateQueryPool(device, &poolInformation, VULKAN_ALLOCATOR, &pool) != VK_SUCCESS)
+                Logger_ThrowError("VK_FAILURE", "Failed to create performance query pool!", true);
+
+            vkResetQueryPool(device, pool, 0, MAX_PERFORMANCE_SCOPES);
+        }
+
+        std::string names;
+
+        for (const auto& counter : counters)
+            names += (names.empty() ? "" : ", ") + counter.name;
+
+        Logger_WriteConsole("Collecting performance counters: " + names, LogLevel::INFO);
+    }
+
+    bool Active()
+    {
+        return supported && enabled && locked;
+    }
+
+    const void* GetSubmitInfo()
+    {
+        return Active() ? &submitInformation : nullptr;
+    }
+
+    double ToDouble(const VkPerformanceCounterResultKHR& result, VkPerformanceCounterStorageKHR storage)
+    {
+        switch (storage)
+        {
+        case VK_PERFORMANCE_COUNTER_STORAGE_INT32_KHR: return (double)result.int32;
+        case VK_PERFORMANCE_COUNTER_STORAGE_INT64_KHR: return (double)result.int64;
+        case VK_PERFORMANCE_COUNTER_STORAGE_UINT32_KHR: return (double)result.uint32;
+        case VK_PERFORMANCE_COUNTER_STORAGE_UINT64_KHR: return (double)result.uint64;
+        case VK_PERFORMANCE_COUNTER_STORAGE_FLOAT32_KHR: return (double)result.float32;
+        case VK_PERFORMANCE_COUNTER_STORAGE_FLOAT64_KHR: return result.float64;
+        default: return 0.0;
+        }
+    }
+
+    const char* GetUnitSuffix(VkPerformanceCounterUnitKHR unit)
+    {
+        switch (unit)
+        {
+        case VK_PERFORMANCE_COUNTER_UNIT_PERCENTAGE_KHR: return "%";
+        case VK_PERFORMANCE_COUNTER_UNIT_NANOSECONDS_KHR: return " ns";
+        case VK_PERFORMANCE_COUNTER_UNIT_BYTES_KHR: return " B";
+        case VK_PERFORMANCE_COUNTER_UNIT_BYTES_PER_SECOND_KHR: return " B/s";
+        case VK_PERFORMANCE_COUNTER_UNIT_KELVIN_KHR: return " K";
+        case VK_PERFORMANCE_COUNTER_UNIT_WATTS_KHR: return " W";
+        case VK_PERFORMANCE_COUNTER_UNIT_VOLTS_KHR: return " V";
+        case VK_PERFORMANCE_COUNTER_UNIT_AMPS_KHR: return " A";
+        case VK_PERFORMANCE_COUNTER_UNIT_HERTZ_KHR: return " Hz";
+        case VK_PERFORMANCE_COUNTER_UNIT_CYCLES_KHR: return " cycles";
+        default: return "";
+        }
+    }
+
+    void Collect(size_t frame)
+    {
+        if (!Active() || frameScopes[frame].empty())
+            return;
+
+        std::vector<PerformanceCounterScope>& scopes = frameScopes[frame];
+        std::vector<VkPerformanceCounterResultKHR> results(scopes.size() * counters.size());
+
+        size_t stride = counters.size() * sizeof(VkPerformanceCounterResultKHR);
+
+        if (vkGetQueryPoolResults(device, queryPools[frame], 0, static_cast<uint32_t>(scopes.size()), results.size() * sizeof(VkPerformanceCounterResultKHR), results.data(), stride, 0) == VK_SUCCESS)
+        {
+            for (size_t i = 0; i < scopes.size(); i++)
+            {
+                auto [entry, inserted] = history.try_emplace(scopes[i].name);
+
+                if (inserted)
+                {
+                    scopeOrder.push_back(scopes[i].name);
+
+                    entry->second.last.assign(counters.size(), 0.0);
+                    entry->second.total.assign(counters.size(), 0.0);
+                }
+
+                for (size_t j = 0; j < counters.size(); j++)
+                {
+                    double value = ToDouble(results[i * counters.size() + j], counters[j].storage);
+
+                    entry->second.last[j] = value;
+                    entry->second.total[j] += value;
+                }
+
+                entry->second.samples++;
+            }
+        }
+
+        vkResetQueryPool(device, queryPools[frame], 0, static_cast<uint32_t>(scopes.size()));
+
+        scopes.clear();
+    }
+
+    void Reset(size_t frame)
+    {
+        currentFrame = static_cast<uint32_t>(frame);
+        scopeOpen = false;
+    }
+
+    void BeginScope(VkCommandBuffer commandBuffer, const std::string& name)
+    {
+        if (!Active() || scopeOpen || frameScopes[currentFrame].size() >= MAX_PERFORMANCE_SCOPES)
+            return;
+
+        std::vector<PerformanceCounterScope>& scopes = frameScopes[currentFrame];
+
+        scopes.push_back({ name, static_cast<uint32_t>(scopes.size()) });
+        scopeOpen = true;
+
+        vkCmdBeginQuery(commandBuffer, queryPools[currentFrame], scopes.back().query, 0);
+    }
+
+    void EndScope(VkCommandBuffer commandBuffer)
+    {
+        if (!Active() || !scopeOpen)
+            return;
+
+        vkCmdEndQuery(commandBuffer, queryPools[currentFrame], frameScopes[currentFrame].back().query);
+
+        scopeOpen = false;
+    }
+
+    PerformanceCounterHistory GetCounters(const std::string& name)
+    {
+        auto found = history.find(name);
+
+        return found != history.end() ? found->second : PerformanceCounterHistory{};
+    }
+
+    void ResetTotals()
+    {
+        for (auto& [name, entry] : history)
+        {
+            entry.last.assign(counters.size(), 0.0);
+            entry.total.assign(counters.size(), 0.0);
+            entry.samples = 0;
+        }
+    }
+
+    void LogSummary()
+    {
+        if (!Active() || scopeOrder.empty())
+            return;
+
+        for (const auto& name : scopeOrder)
+        {
+            const PerformanceCounterHistory& entry = history[name];
+
+            if (entry.samples == 0)
+                continue;
+
+            std::string line = std::format("Pass {} counters:", name);
+
+            for (size_t i = 0; i < counters.size(); i++)
+                line += std::format(" {} {:.2f}{}{}", counters[i].name, entry.total[i] / entry.samples, GetUnitSuffix(counters[i].unit), i + 1 < counters.size() ? "," : "");
+
+            Logger_WriteConsole(line, LogLevel::INFO);
+        }
+    }
+
+    void CleanUp()
+    {
+        for (VkQueryPool pool : queryPools)
+            vkDestroyQueryPool(device, pool, VULKAN_ALLOCATOR);
+
+        queryPools.clear();
+        frameScopes.clear();
+
+        if (locked)
+            releaseProfilingLock(device);
+
+        locked = false;
+    }
+}
+
+#endif // !PERFORMANCE_COUNTERS_HPP
@@ -0,0 +1,163 @@
+#ifndef PIPELINE_CACHE_HPP
+#define PIPELINE_CACHE_HPP
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <atomic>
+#include <cstring>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core/AllocationTracker.hpp"
+#include "core/Logger.hpp"
+
+#define PIPELINE_CACHE_PATH "cache/pipeline.bin"
+
+namespace PipelineCache
+{
+    VkPipelineCache cache = VK_NULL_HANDLE;
+    VkDevice device;
+    VkPhysicalDeviceProperties deviceProperties;
+
+    bool warm = false;
+    std::atomic<size_t> pipelinesCreated = 0;
+    std::atomic<long long> creationTime = 0;
+
+    bool Validate(const std::vector<char>& data)
+    {
+        VkPipelineCacheHeaderVersionOne header = {};
+
+        if (data.size() < sizeof(header))
+            return false;
+
+        memcpy(&header, data.data(), sizeof(header));
+
+        if (header.headerSize < sizeof(header) || header.headerSize > data.size())
+            return false;
+
+        if (header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+            return false;
+
+        if (header.vendorID != deviceProperties.vendorID || header.deviceID != deviceProperties.deviceID)
+            return false;
+
+        return memcmp(header.pipelineCacheUUID, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+
+    std::vector<char> ReadCacheFile(const std::string& filename)
+    {
+        std::ifstream file(filename, std::ios::ate | std::ios::binary);
+
+        if (!file.is_open())
+            return {};
+
+        size_t fileSize = (size_t)file.tellg();
+        std::vector<char> buffer(fileSize);
+
+        file.seekg(0);
+        file.read(buffer.data(), fileSize);
+
+        if (!file)
+            return {};
+
+        return buffer;
+    }
+
+    void Load(VkDevice device, VkPhysicalDevice physicalDevice)
+    {
+        PipelineCache::device = device;
+        vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+
+        std::vector<char> data = ReadCacheFile(PIPELINE_CACHE_PATH);
+
+        warm = !data.empty() && Validate(data);
+
+        if (!data.empty() && !warm)
+            Logger_WriteConsole("Pipeline cache on disk belongs to another driver or device, discarding it", LogLevel::WARNING);
+
+        VkPipelineCacheCreateInfo creationInformation = {};
+
+        creationInformation.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        creationInformation.initialDataSize = warm ? data.size() : 0;
+        creationInformation.pInitialData = warm ? data.data() : nullptr;
+
+        if (vkCreatePipelineCache(device, &creationInformation, VULKAN_ALLOCATOR, &cache) != VK_SUCCESS)
+            Logger_ThrowError("VK_FAILURE", "Failed to create pipeline cache!", true);
+
+        Logger_WriteConsole(warm ? std::format("Loaded pipeline cache ({} bytes)", data.size()) : std::string("No usable pipeline cache, starting cold"), LogLevel::INFO);
+    }
+
+    void RecordCreation(std::chrono::nanoseconds duration)
+    {
+        pipelinesCreated.fetch_add(1, std::memory_order_relaxed);
+        creationTime.fetch_add(duration.count(), std::memory_order_relaxed);
+    }
+
+    void Save()
+    {
+        if (cache == VK_NULL_HANDLE)
+            return;
+
+        size_t dataSize = 0;
+
+        if (vkGetPipelineCacheData(device, cache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0)
+            return;
+
+        std::vector<char> data(dataSize);
+
+        if (vkGetPipelineCacheData(device, cache, &dataSize, data.data()) != VK_SUCCESS)
+        {
+            Logger_ThrowError("VK_FAILURE", "Failed to read back pipeline cache data!", false);
+            return;
+        }
+
+        std::filesystem::path path = PIPELINE_CACHE_PATH;
+        std::filesystem::path temporaryPath = path.string() + ".tmp";
+        std::error_code error;
+
+        std::filesystem::create_directories(path.parent_path(), error);
+
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+
+            file.write(data.data(), dataSize);
+            file.flush();
+
+            if (!file)
+            {
+                Logger_ThrowError("IO_FAILURE", "Failed to write pipeline cache to '" + temporaryPath.string() + "'", false);
+                std::filesystem::remove(temporaryPath, error);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path, error);
+
+        if (error)
+        {
+            Logger_ThrowError("IO_FAILURE", "Failed to replace pipeline cache: " + error.message(), false);
+            std::filesystem::remove(temporaryPath, error);
+            return;
+        }
+
+        Logger_WriteConsole(std::format("Saved pipeline cache ({} bytes)", dataSize), LogLevel::DEBUG);
+    }
+
+    void CleanUp()
+    {
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::nanoseconds(creationTime.load())).count();
+
+        Logger_WriteConsole(std::format("Created {} pipeline(s) in {:.3f} ms ({} start)", pipelinesCreated.load(), milliseconds, warm ? "warm" : "cold"), LogLevel::INFO);
+
+        Save();
+
+        vkDestroyPipelineCache(device, cache, VULKAN_ALLOCATOR);
+        cache = VK_NULL_HANDLE;
+    }
+}
+
+#endif // !PIPELINE_CACHE_HPP
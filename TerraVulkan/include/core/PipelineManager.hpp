@@ -2,82 +2,780 @@
 #define PIPELINE_MANAGER_HPP
 
 #include <vector>
+#include <deque>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <set>
+#include <functional>
+#include <sstream>
+#include <unordered_map>
 
 #define GLFW_INCLUDE_VULKAN
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include "core/AllocationTracker.hpp"
 #include "core/Logger.hpp"
+#include "core/PipelineCache.hpp"
+#include "core/Profiler.hpp"
+#include "core/LayoutCache.hpp"
+#include "render/ShaderModuleCache.hpp"
+#include "thread/ThreadTaskExecutor.hpp"
+#include "util/Hash.hpp"
+
+#define INVALID_PIPELINE_HANDLE UINT32_MAX
+#define PIPELINE_WARM_UP_PATH "cache/pipelines.warmup"
+#define MAX_PIPELINE_WORKERS 4
+#define MAX_SPECIALIZATION_CONSTANTS 8
+
+// Reverse-Z: the near plane maps to 1 and the far plane to 0, which spreads float precision evenly across the view distance
+#define DEPTH_CLEAR_VALUE 0.0f
+#define DEPTH_COMPARE_OP VK_COMPARE_OP_GREATER_OR_EQUAL
+
+typedef uint32_t PipelineHandle;
+
+enum class BlendMode : uint8_t
+{
+    DISABLED,
+    ALPHA,
+    ADDITIVE,
+    PREMULTIPLIED
+};
+
+enum class PipelineStatus : uint8_t
+{
+    COMPILING,
+    READY,
+    INVALID
+};
+
+struct PipelineState
+{
+    uint64_t vertexHash = 0;
+    uint64_t fragmentHash = 0;
+
+    VkShaderModule vertexShader = VK_NULL_HANDLE;
+    VkShaderModule fragmentShader = VK_NULL_HANDLE;
+
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    uint32_t subpass = 0;
+    VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+
+    VkVertexInputBindingDescription vertexBinding = {};
+    std::vector<VkVertexInputAttributeDescription> vertexAttributes = {};
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    BlendMode blend = BlendMode::DISABLED;
+
+    bool depthTest = false;
+    bool depthWrite = false;
+    VkCompareOp depthCompare = DEPTH_COMPARE_OP;
+    bool colorWrite = true;
+
+    VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+    VkCullModeFlags cullMode = VK_CULL_MODE_NONE;
+    VkFrontFace frontFace = VK_FRONT_FACE_CLOCKWISE;
+
+    uint32_t specialization = 0;
+
+    uint64_t GetHash() const
+    {
+        uint64_t hash = HASH_FNV_OFFSET;
+
+        hash = Hash::Combine(hash, vertexHash);
+        hash = Hash::Combine(hash, fragmentHash);
+        hash = Hash::Combine(hash, renderPass);
+        hash = Hash::Combine(hash, subpass);
+        hash = Hash::Combine(hash, colorFormat);
+        hash = Hash::Combine(hash, depthFormat);
+
+        hash = Hash::Combine(hash, vertexBinding.binding);
+        hash = Hash::Combine(hash, vertexBinding.stride);
+        hash = Hash::Combine(hash, vertexBinding.inputRate);
+
+        for (const auto& attribute : vertexAttributes)
+        {
+            hash = Hash::Combine(hash, attribute.location);
+            hash = Hash::Combine(hash, attribute.binding);
+            hash = Hash::Combine(hash, attribute.format);
+            hash = Hash::Combine(hash, attribute.offset);
+        }
+
+        hash = Hash::Combine(hash, topology);
+        hash = Hash::Combine(hash, blend);
+        hash = Hash::Combine(hash, depthTest);
+        hash = Hash::Combine(hash, depthWrite);
+        hash = Hash::Combine(hash, depthCompare);
+        hash = Hash::Combine(hash, colorWrite);
+        hash = Hash::Combine(hash, polygonMode);
+        hash = Hash::Combine(hash, cullMode);
+        hash = Hash::Combine(hash, frontFace);
+        hash = Hash::Combine(hash, specialization);
+
+        return hash;
+    }
+
+    void CopyFixedFunction(const PipelineState& other)
+    {
+        topology = other.topology;
+        blend = other.blend;
+        depthTest = other.depthTest;
+        depthWrite = other.depthWrite;
+        depthCompare = other.depthCompare;
+        colorWrite = other.colorWrite;
+        polygonMode = other.polygonMode;
+        cullMode = other.cullMode;
+        frontFace = other.frontFace;
+    }
+
+    bool operator==(const PipelineState& other) const
+    {
+        if (vertexAttributes.size() != other.vertexAttributes.size())
+            return false;
+
+        for (size_t i = 0; i < vertexAttributes.size(); i++)
+        {
+            const auto& a = vertexAttributes[i];
+            const auto& b = other.vertexAttributes[i];
+
+            if (a.location != b.location || a.binding != b.binding || a.format != b.format || a.offset != b.offset)
+                return false;
+        }
+
+        return vertexHash == other.vertexHash && fragmentHash == other.fragmentHash &&
+            renderPass == other.renderPass && subpass == other.subpass && colorFormat == other.colorFormat && depthFormat == other.depthFormat &&
+            vertexBinding.binding == other.vertexBinding.binding && vertexBinding.stride == other.vertexBinding.stride && vertexBinding.inputRate == other.vertexBinding.inputRate &&
+            topology == other.topology && blend == other.blend &&
+            depthTest == other.depthTest && depthWrite == other.depthWrite && depthCompare == other.depthCompare && colorWrite == other.colorWrite &&
+            polygonMode == other.polygonMode && cullMode == other.cullMode && frontFace == other.frontFace &&
+            specialization == other.specialization;
+    }
+};
+
+struct PipelineStateHasher
+{
+    size_t operator()(const PipelineState& state) const
+    {
+        return (size_t)state.GetHash();
+    }
+};
+
+struct Pipeline
+{
+    std::string name = "";
+    PipelineState state = {};
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    const PipelineLayoutDescription* layoutDescription = nullptr;
+
+    PipelineHandle fallback = INVALID_PIPELINE_HANDLE;
+    PipelineHandle redirect = INVALID_PIPELINE_HANDLE;
+    std::atomic<PipelineStatus> status = PipelineStatus::COMPILING;
+};
+
+struct PipelineWarmUpEntry
+{
+    std::string name = "";
+    PipelineState state = {};
+};
 
 namespace PipelineManager
 {
-	VkPipelineLayout pipelineLayout;
-	VkPipeline graphicsPipeline;
+    std::deque<Pipeline> pipelines;
+    std::unordered_map<PipelineState, PipelineHandle, PipelineStateHasher> pipelineLookup;
+    std::vector<std::pair<PipelineHandle, PipelineHandle>> pendingSwaps;
     VkDevice device;
 
-    void GenerateLayout() 
+    std::vector<std::unique_ptr<ThreadTaskExecutor>> workers;
+    size_t nextWorker = 0;
+    size_t pendingCompiles = 0;
+    std::mutex pendingMutex;
+    std::condition_variable pendingCondition;
+
+    std::vector<std::function<void()>> completedTasks;
+    std::mutex completedMutex;
+
+    char GetFormatClass(VkFormat format)
     {
-        VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
-        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        switch (format)
+        {
+        case VK_FORMAT_R8_SINT: case VK_FORMAT_R8G8_SINT: case VK_FORMAT_R8G8B8_SINT: case VK_FORMAT_R8G8B8A8_SINT:
+        case VK_FORMAT_R16_SINT: case VK_FORMAT_R16G16_SINT: case VK_FORMAT_R16G16B16_SINT: case VK_FORMAT_R16G16B16A16_SINT:
+        case VK_FORMAT_R32_SINT: case VK_FORMAT_R32G32_SINT: case VK_FORMAT_R32G32B32_SINT: case VK_FORMAT_R32G32B32A32_SINT:
+            return 'i';
+
+        case VK_FORMAT_R8_UINT: case VK_FORMAT_R8G8_UINT: case VK_FORMAT_R8G8B8_UINT: case VK_FORMAT_R8G8B8A8_UINT:
+        case VK_FORMAT_R16_UINT: case VK_FORMAT_R16G16_UINT: case VK_FORMAT_R16G16B16_UINT: case VK_FORMAT_R16G16B16A16_UINT:
+        case VK_FORMAT_R32_UINT: case VK_FORMAT_R32G32_UINT: case VK_FORMAT_R32G32B32_UINT: case VK_FORMAT_R32G32B32A32_UINT:
+        case VK_FORMAT_A2B10G10R10_UINT_PACK32:
+            return 'u';
+
+        default:
+            return 'f';
+        }
+    }
+
+    bool ValidateVertexInput(const PipelineState& state, const ShaderReflection& reflection)
+    {
+        for (const ShaderInput& input : reflection.inputs)
+        {
+            auto attribute = std::find_if(state.vertexAttributes.begin(), state.vertexAttributes.end(), [&](const VkVertexInputAttributeDescription& other) { return other.location == input.location; });
+
+            if (attribute == state.vertexAttributes.end())
+            {
+                Logger_ThrowError("SPIR-V", std::format("Vertex shader reads location {} but the vertex layout has no attribute there", input.location), false);
+                return false;
+            }
+
+            if (GetFormatClass(attribute->format) != GetFormatClass(input.format))
+            {
+                Logger_ThrowError("SPIR-V", std::format("Vertex attribute at location {} does not match the shader input's numeric type", input.location), false);
+                return false;
+            }
+        }
 
-        if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
-            Logger_ThrowError("VK_FAILURE", "Failed to create pipeline layout!", true);
+        return true;
     }
 
-    VkPipeline GenerateGraphics(VkRenderPass renderPass, VkShaderModule vertexShader, VkShaderModule fragmentShader) 
+    VkPipelineColorBlendAttachmentState GetBlendAttachment(BlendMode mode)
     {
-        GenerateLayout();
+        VkPipelineColorBlendAttachmentState attachment = {};
+
+        attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        attachment.blendEnable = mode == BlendMode::DISABLED ? VK_FALSE : VK_TRUE;
+        attachment.colorBlendOp = VK_BLEND_OP_ADD;
+        attachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        attachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        attachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+
+        switch (mode)
+        {
+        case BlendMode::ALPHA:
+            attachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+            attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+            break;
+
+        case BlendMode::ADDITIVE:
+            attachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+            attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+            attachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+            break;
+
+        case BlendMode::PREMULTIPLIED:
+            attachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+            attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+            break;
+
+        default:
+            attachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+            attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+            break;
+        }
+
+        return attachment;
+    }
+
+    VkPipeline GenerateGraphics(const PipelineState& state, VkPipelineLayout layout)
+    {
+        TERRA_PROFILE_FUNCTION();
+        TERRA_ALLOCATION_SCOPE(AllocationTag::PIPELINE);
+
+        VkSpecializationMapEntry specializationEntries[MAX_SPECIALIZATION_CONSTANTS] = {};
+        VkBool32 specializationData[MAX_SPECIALIZATION_CONSTANTS] = {};
+
+        for (uint32_t i = 0; i < MAX_SPECIALIZATION_CONSTANTS; i++)
+        {
+            specializationEntries[i].constantID = i;
+            specializationEntries[i].offset = i * sizeof(VkBool32);
+            specializationEntries[i].size = sizeof(VkBool32);
+
+            specializationData[i] = (state.specialization >> i) & 1 ? VK_TRUE : VK_FALSE;
+        }
+
+        VkSpecializationInfo specializationInfo = {};
+
+        specializationInfo.mapEntryCount = MAX_SPECIALIZATION_CONSTANTS;
+        specializationInfo.pMapEntries = specializationEntries;
+        specializationInfo.dataSize = sizeof(specializationData);
+        specializationInfo.pData = specializationData;
 
         VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
 
         vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-        vertShaderStageInfo.module = vertexShader;
+        vertShaderStageInfo.module = state.vertexShader;
         vertShaderStageInfo.pName = "main";
+        vertShaderStageInfo.pSpecializationInfo = &specializationInfo;
 
         VkPipelineShaderStageCreateInfo fragShaderStageInfo = {};
 
         fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-        fragShaderStageInfo.module = fragmentShader;
+        fragShaderStageInfo.module = state.fragmentShader;
         fragShaderStageInfo.pName = "main";
+        fragShaderStageInfo.pSpecializationInfo = &specializationInfo;
 
         VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
 
+        VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
+
+        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInputInfo.vertexBindingDescriptionCount = state.vertexAttributes.empty() ? 0 : 1;
+        vertexInputInfo.pVertexBindingDescriptions = &state.vertexBinding;
+        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(state.vertexAttributes.size());
+        vertexInputInfo.pVertexAttributeDescriptions = state.vertexAttributes.data();
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = state.topology;
+        inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+        VkPipelineViewportStateCreateInfo viewportState = {};
+
+        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportState.viewportCount = 1;
+        viewportState.scissorCount = 1;
+
+        VkPipelineRasterizationStateCreateInfo rasterizer = {};
+
+        rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizer.polygonMode = state.polygonMode;
+        rasterizer.cullMode = state.cullMode;
+        rasterizer.frontFace = state.frontFace;
+        rasterizer.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo multisampling = {};
+
+        multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+
+        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencil.depthTestEnable = state.depthTest ? VK_TRUE : VK_FALSE;
+        depthStencil.depthWriteEnable = state.depthWrite ? VK_TRUE : VK_FALSE;
+        depthStencil.depthCompareOp = state.depthCompare;
+
+        VkPipelineColorBlendAttachmentState colorBlendAttachment = GetBlendAttachment(state.blend);
 
+        if (!state.colorWrite)
+            colorBlendAttachment.colorWriteMask = 0;
+
+        VkPipelineColorBlendStateCreateInfo colorBlending = {};
+
+        colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlending.attachmentCount = 1;
+        colorBlending.pAttachments = &colorBlendAttachment;
+
+        VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+        VkPipelineDynamicStateCreateInfo dynamicState = {};
+
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = 2;
+        dynamicState.pDynamicStates = dynamicStates;
+
+        VkPipelineRenderingCreateInfo renderingInfo = {};
+
+        renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachmentFormats = &state.colorFormat;
+        renderingInfo.depthAttachmentFormat = state.depthFormat;
 
         VkGraphicsPipelineCreateInfo pipelineInfo{};
         pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.pNext = state.renderPass == VK_NULL_HANDLE ? &renderingInfo : nullptr;
         pipelineInfo.stageCount = 2;
         pipelineInfo.pStages = shaderStages;
-        pipelineInfo.layout = pipelineLayout;
-        pipelineInfo.renderPass = renderPass;
-        pipelineInfo.subpass = 0;
+        pipelineInfo.pVertexInputState = &vertexInputInfo;
+        pipelineInfo.pInputAssemblyState = &inputAssembly;
+        pipelineInfo.pViewportState = &viewportState;
+        pipelineInfo.pRasterizationState = &rasterizer;
+        pipelineInfo.pMultisampleState = &multisampling;
+        pipelineInfo.pDepthStencilState = &depthStencil;
+        pipelineInfo.pColorBlendState = &colorBlending;
+        pipelineInfo.pDynamicState = &dynamicState;
+        pipelineInfo.layout = layout;
+        pipelineInfo.renderPass = state.renderPass;
+        pipelineInfo.subpass = state.subpass;
+
+        VkPipeline graphicsPipeline = VK_NULL_HANDLE;
+
+        auto start = std::chrono::steady_clock::now();
+
+        VkResult result = vkCreateGraphicsPipelines(device, PipelineCache::cache, 1, &pipelineInfo, VULKAN_ALLOCATOR, &graphicsPipeline);
+
+        PipelineCache::RecordCreation(std::chrono::steady_clock::now() - start);
+
+        if (result != VK_SUCCESS)
+        {
+            Logger_ThrowError("VK_FAILURE", std::format("Failed to create graphics pipeline! Code: {}", (int)result), false);
+            return VK_NULL_HANDLE;
+        }
 
-        if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS) 
-            Logger_ThrowError("VK_FAILURE", "Failed to create graphics pipeline!", true);
-        
         return graphicsPipeline;
     }
 
-    void PreInitialize(VkDevice device)
+    void PreInitialize(VkDevice device, VkPhysicalDevice physicalDevice)
     {
         PipelineManager::device = device;
+
+        ShaderModuleCache::Initialize(device);
+        LayoutCache::Initialize(device);
+        PipelineCache::Load(device, physicalDevice);
+
+        size_t workerCount = std::clamp<size_t>(std::thread::hardware_concurrency() / 2, 1, MAX_PIPELINE_WORKERS);
+
+        for (size_t i = 0; i < workerCount; i++)
+            workers.push_back(std::make_unique<ThreadTaskExecutor>());
+    }
+
+    void Compile(Pipeline& pipeline)
+    {
+        pipeline.status.store(PipelineStatus::COMPILING, std::memory_order_relaxed);
+
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            pendingCompiles++;
+        }
+
+        ShaderModuleCache::Retain(pipeline.state.vertexHash);
+        ShaderModuleCache::Retain(pipeline.state.fragmentHash);
+
+        Pipeline* target = &pipeline;
+
+        workers[nextWorker++ % workers.size()]->AddTask([target]
+        {
+            target->pipeline = GenerateGraphics(target->state, target->layout);
+            target->status.store(target->pipeline != VK_NULL_HANDLE ? PipelineStatus::READY : PipelineStatus::INVALID, std::memory_order_release);
+
+            ShaderModuleCache::Release(target->state.vertexHash);
+            ShaderModuleCache::Release(target->state.fragmentHash);
+
+            {
+                std::lock_guard<std::mutex> lock(pendingMutex);
+                pendingCompiles--;
+            }
+
+            pendingCondition.notify_all();
+        });
     }
 
-    void Initialize(VkRenderPass renderPass, VkShaderModule vertShaderModule, VkShaderModule fragShaderModule) 
+    // Runs work on a pipeline worker and the then callback on the main thread during the next Update
+    void Dispatch(std::function<void()> work, std::function<void()> then)
     {
-        graphicsPipeline = GenerateGraphics(renderPass, vertShaderModule, fragShaderModule);
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            pendingCompiles++;
+        }
+
+        workers[nextWorker++ % workers.size()]->AddTask([work = std::move(work), then = std::move(then)]
+        {
+            work();
+
+            {
+                std::lock_guard<std::mutex> lock(completedMutex);
+                completedTasks.push_back(then);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(pendingMutex);
+                pendingCompiles--;
+            }
+
+            pendingCondition.notify_all();
+        });
+    }
+
+    void WaitIdle()
+    {
+        std::unique_lock<std::mutex> lock(pendingMutex);
+        pendingCondition.wait(lock, [] { return pendingCompiles == 0; });
+    }
+
+    PipelineHandle Request(const PipelineState& state, const std::string& name = "", PipelineHandle fallback = INVALID_PIPELINE_HANDLE)
+    {
+        auto found = pipelineLookup.find(state);
+
+        if (found != pipelineLookup.end())
+            return found->second;
+
+        PipelineHandle handle = static_cast<PipelineHandle>(pipelines.size());
+        Pipeline& pipeline = pipelines.emplace_back();
+
+        pipeline.name = name;
+        pipeline.state = state;
+        pipeline.fallback = fallback;
+
+        pipelineLookup.insert({ state, handle });
+
+        const ShaderReflection& vertexReflection = ShaderModuleCache::GetReflection(state.vertexHash);
+        const ShaderReflection& fragmentReflection = ShaderModuleCache::GetReflection(state.fragmentHash);
+
+        if (!ValidateVertexInput(state, vertexReflection))
+        {
+            pipeline.status.store(PipelineStatus::INVALID);
+            return handle;
+        }
+
+        pipeline.layoutDescription = &LayoutCache::GetPipelineLayout({ &vertexReflection, &fragmentReflection });
+        pipeline.layout = pipeline.layoutDescription->layout;
+
+        Compile(pipeline);
+
+        return handle;
+    }
+
+    PipelineHandle Reserve(const std::string& name, PipelineHandle fallback)
+    {
+        PipelineHandle handle = static_cast<PipelineHandle>(pipelines.size());
+        Pipeline& pipeline = pipelines.emplace_back();
+
+        pipeline.name = name;
+        pipeline.fallback = fallback;
+
+        return handle;
+    }
+
+    PipelineHandle Resolve(PipelineHandle handle)
+    {
+        while (handle != INVALID_PIPELINE_HANDLE && pipelines[handle].redirect != INVALID_PIPELINE_HANDLE)
+            handle = pipelines[handle].redirect;
+
+        return handle;
     }
 
-    void RegisterShader(VkRenderPass renderPass, const VkShaderModule& vertexShader, const VkShaderModule& fragmentShader) 
+    bool IsReady(PipelineHandle handle)
     {
-        Initialize(renderPass, vertexShader, fragmentShader);
+        handle = Resolve(handle);
+
+        return handle != INVALID_PIPELINE_HANDLE && pipelines[handle].status.load(std::memory_order_acquire) == PipelineStatus::READY;
+    }
+
+    void Replace(PipelineHandle handle, const PipelineState& state)
+    {
+        handle = Resolve(handle);
+
+        if (handle == INVALID_PIPELINE_HANDLE)
+            return;
+
+        PipelineHandle next = Request(state, pipelines[handle].name, pipelines[handle].fallback);
+
+        if (next != handle)
+            pendingSwaps.push_back({ handle, next });
+    }
+
+    void Update()
+    {
+        std::vector<std::function<void()>> completed;
+
+        {
+            std::lock_guard<std::mutex> lock(completedMutex);
+            completed.swap(completedTasks);
+        }
+
+        for (auto& task : completed)
+            task();
+
+        bool waited = false;
+
+        for (auto swap = pendingSwaps.begin(); swap != pendingSwaps.end();)
+        {
+            auto [handle, next] = *swap;
+            PipelineStatus status = pipelines[next].status.load(std::memory_order_acquire);
+
+            if (status == PipelineStatus::COMPILING)
+            {
+                swap++;
+                continue;
+            }
+
+            swap = pendingSwaps.erase(swap);
+
+            if (status == PipelineStatus::INVALID)
+            {
+                Logger_WriteConsole("Replacement for pipeline '" + pipelines[handle].name + "' failed to build, keeping the old one", LogLevel::WARNING);
+                continue;
+            }
+
+            if (!waited)
+            {
+                vkDeviceWaitIdle(device);
+                waited = true;
+            }
+
+            Pipeline& pipeline = pipelines[handle];
+
+            auto found = pipelineLookup.find(pipeline.state);
+
+            if (found != pipelineLookup.end() && found->second == handle)
+                pipelineLookup.erase(found);
+
+            vkDestroyPipeline(device, pipeline.pipeline, VULKAN_ALLOCATOR);
+
+            pipeline.pipeline = VK_NULL_HANDLE;
+            pipeline.redirect = next;
+            pipeline.status.store(PipelineStatus::INVALID);
+
+            for (auto& other : pipelines)
+            {
+                if (other.redirect == handle)
+                    other.redirect = next;
+            }
+        }
     }
 
-    void CleanUp() 
+    Pipeline& Get(PipelineHandle handle)
     {
-        vkDestroyPipeline(device, graphicsPipeline, nullptr);
-        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+        return pipelines[handle];
+    }
+
+    bool Bind(VkCommandBuffer commandBuffer, PipelineHandle handle)
+    {
+        handle = Resolve(handle);
+
+        if (handle == INVALID_PIPELINE_HANDLE)
+            return false;
+
+        if (!IsReady(handle))
+            return IsReady(pipelines[handle].fallback) && Bind(commandBuffer, pipelines[handle].fallback);
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines[handle].pipeline);
+
+        return true;
+    }
+
+    void Retarget(VkRenderPass from, VkRenderPass to, VkFormat fromFormat, VkFormat toFormat)
+    {
+        WaitIdle();
+
+        pipelineLookup.clear();
+
+        for (PipelineHandle handle = 0; handle < pipelines.size(); handle++)
+        {
+            Pipeline& pipeline = pipelines[handle];
+
+            if (pipeline.redirect != INVALID_PIPELINE_HANDLE || pipeline.state.vertexHash == 0)
+                continue;
+
+            if (pipeline.state.renderPass == from && pipeline.state.colorFormat == fromFormat)
+            {
+                vkDestroyPipeline(device, pipeline.pipeline, VULKAN_ALLOCATOR);
+
+                pipeline.pipeline = VK_NULL_HANDLE;
+                pipeline.state.renderPass = to;
+                pipeline.state.colorFormat = toFormat;
+                pipeline.state.vertexShader = ShaderModuleCache::AcquireByHash(pipeline.state.vertexHash);
+                pipeline.state.fragmentShader = ShaderModuleCache::AcquireByHash(pipeline.state.fragmentHash);
+
+                if (pipeline.layout != VK_NULL_HANDLE && pipeline.state.vertexShader != VK_NULL_HANDLE && pipeline.state.fragmentShader != VK_NULL_HANDLE)
+                    pipeline.pipeline = GenerateGraphics(pipeline.state, pipeline.layout);
+
+                if (pipeline.state.vertexShader != VK_NULL_HANDLE)
+                    ShaderModuleCache::Release(pipeline.state.vertexHash);
+
+                if (pipeline.state.fragmentShader != VK_NULL_HANDLE)
+                    ShaderModuleCache::Release(pipeline.state.fragmentHash);
+
+                pipeline.status.store(pipeline.pipeline != VK_NULL_HANDLE ? PipelineStatus::READY : PipelineStatus::INVALID);
+            }
+
+            pipelineLookup.insert({ pipeline.state, handle });
+        }
+    }
+
+    std::vector<PipelineWarmUpEntry> LoadWarmUpList()
+    {
+        std::vector<PipelineWarmUpEntry> entries;
+        std::ifstream file(PIPELINE_WARM_UP_PATH);
+
+        if (!file.is_open())
+            return entries;
+
+        std::string line;
+
+        while (std::getline(file, line))
+        {
+            std::istringstream stream(line);
+            PipelineWarmUpEntry entry = {};
+            int topology, blend, depthTest, depthWrite, depthCompare, polygonMode, cullMode, frontFace;
+            uint32_t specialization = 0;
+            int colorWrite = 1;
+
+            if (!(stream >> entry.name >> topology >> blend >> depthTest >> depthWrite >> depthCompare >> polygonMode >> cullMode >> frontFace))
+                continue;
+
+            stream >> specialization >> colorWrite;
+
+            entry.state.topology = (VkPrimitiveTopology)topology;
+            entry.state.blend = (BlendMode)blend;
+            entry.state.depthTest = depthTest != 0;
+            entry.state.depthWrite = depthWrite != 0;
+            entry.state.depthCompare = (VkCompareOp)depthCompare;
+            entry.state.polygonMode = (VkPolygonMode)polygonMode;
+            entry.state.cullMode = (VkCullModeFlags)cullMode;
+            entry.state.frontFace = (VkFrontFace)frontFace;
+            entry.state.specialization = specialization;
+            entry.state.colorWrite = colorWrite != 0;
+
+            entries.push_back(entry);
+        }
+
+        return entries;
+    }
+
+    void SaveWarmUpList()
+    {
+        std::set<std::string> lines;
+
+        for (const auto& pipeline : pipelines)
+        {
+            if (pipeline.name.empty() || pipeline.status.load() != PipelineStatus::READY)
+                continue;
+
+            const PipelineState& state = pipeline.state;
+
+            lines.insert(std::format("{} {} {} {} {} {} {} {} {} {} {}", pipeline.name, (int)state.topology, (int)state.blend, (int)state.depthTest, (int)state.depthWrite,
+                (int)state.depthCompare, (int)state.polygonMode, (int)state.cullMode, (int)state.frontFace, state.specialization, (int)state.colorWrite));
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(PIPELINE_WARM_UP_PATH).parent_path(), error);
+
+        std::ofstream file(PIPELINE_WARM_UP_PATH, std::ios::trunc);
+
+        for (const auto& line : lines)
+            file << line << "\n";
+    }
+
+    void CleanUp()
+    {
+        WaitIdle();
+
+        pendingSwaps.clear();
+        completedTasks.clear();
+
+        for (auto& worker : workers)
+            worker->Terminate();
+
+        workers.clear();
+
+        SaveWarmUpList();
+
+        for (auto& pipeline : pipelines)
+            vkDestroyPipeline(device, pipeline.pipeline, VULKAN_ALLOCATOR);
+
+        pipelines.clear();
+        pipelineLookup.clear();
+
+        LayoutCache::CleanUp();
+        ShaderModuleCache::CleanUp();
+
+        PipelineCache::CleanUp();
     }
 }
 
@@ -0,0 +1,252 @@
+#ifndef PIPELINE_STATISTICS_HPP
+#define PIPELINE_STATISTICS_HPP
+
+#include <string>
+#include <vector>
+#include <format>
+#include <unordered_map>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core/AllocationTracker.hpp"
+#include "core/Logger.hpp"
+
+#define MAX_STATISTICS_SCOPES 32
+
+#define PIPELINE_STATISTICS_FLAGS \
+    (VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT | VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT | \
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT | \
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT | \
+    VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT)
+
+// Laid out in the order of PIPELINE_STATISTICS_FLAGS' bits, which is the order the query writes them in
+struct PipelineCounters
+{
+    uint64_t inputVertices = 0;
+    uint64_t inputPrimitives = 0;
+    uint64_t vertexInvocations = 0;
+    uint64_t clippingInvocations = 0;
+    uint64_t clippingPrimitives = 0;
+    uint64_t fragmentInvocations = 0;
+    uint64_t computeInvocations = 0;
+
+    PipelineCounters& operator+=(const PipelineCounters& other)
+    {
+        inputVertices += other.inputVertices;
+        inputPrimitives += other.inputPrimitives;
+        vertexInvocations += other.vertexInvocations;
+        clippingInvocations += other.clippingInvocations;
+        clippingPrimitives += other.clippingPrimitives;
+        fragmentInvocations += other.fragmentInvocations;
+        computeInvocations += other.computeInvocations;
+
+        return *this;
+    }
+};
+
+struct PipelineCounterHistory
+{
+    PipelineCounters last = {};
+    PipelineCounters total = {};
+    uint64_t samples = 0;
+
+    double Average(uint64_t PipelineCounters::* field) const
+    {
+        return samples > 0 ? (double)(total.*field) / samples : 0.0;
+    }
+};
+
+struct OverdrawSample
+{
+    uint64_t fragmentInvocations = 0;
+    uint64_t pixels = 0;
+
+    double GetOverdraw() const
+    {
+        return pixels > 0 ? (double)fragmentInvocations / pixels : 0.0;
+    }
+};
+
+struct PipelineStatisticsScope
+{
+    std::string name = "";
+    uint32_t query = 0;
+};
+
+namespace PipelineStatistics
+{
+    std::vector<VkQueryPool> queryPools;
+    std::vector<std::vector<PipelineStatisticsScope>> frameScopes;
+    std::vector<uint64_t> pendingPixels;
+
+    std::unordered_map<std::string, PipelineCounterHistory> history;
+    std::vector<std::string> scopeOrder;
+
+    OverdrawSample last = {};
+    OverdrawSample total = {};
+    uint64_t frames = 0;
+
+    uint32_t currentFrame = 0;
+    bool scopeOpen = false;
+
+    bool supported = false;
+    bool enabled = false;
+
+    VkDevice device;
+
+    void Initialize(VkDevice device, const VkPhysicalDeviceFeatures& features, uint32_t frameCount)
+    {
+        PipelineStatistics::device = device;
+        supported = features.pipelineStatisticsQuery == VK_TRUE;
+
+        if (!supported)
+        {
+            if (enabled)
+                Logger_WriteConsole("Device does not support pipeline statistics queries, pass counters and overdraw will not be measured", LogLevel::WARNING);
+
+            return;
+        }
+
+        queryPools.resize(frameCount);
+        frameScopes.resize(frameCount);
+        pendingPixels.assign(frameCount, 0);
+
+        VkQueryPoolCreateInfo poolInformation = {};
+
+        poolInformation.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInformation.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        poolInformation.queryCount = MAX_STATISTICS_SCOPES;
+        poolInformation.pipelineStatistics = PIPELINE_STATISTICS_FLAGS;
+
+        for (auto& pool : queryPools)
+        {
+            if (vkCreateQueryPool(device, &poolInformation, VULKAN_ALLOCATOR, &pool) != VK_SUCCESS)
+                Logger_ThrowError("VK_FAILURE", "Failed to create pipeline statistics query pool!", true);
+        }
+    }
+
+    bool Active()
+    {
+        return supported && enabled;
+    }
+
+    void Collect(size_t frame)
+    {
+        if (!Active() || frameScopes[frame].empty())
+            return;
+
+        std::vector<PipelineStatisticsScope>& scopes = frameScopes[frame];
+        std::vector<PipelineCounters> results(scopes.size());
+
+        VkResult result = vkGetQueryPoolResults(device, queryPools[frame], 0, static_cast<uint32_t>(results.size()), results.size() * sizeof(PipelineCounters), results.data(), sizeof(PipelineCounters), VK_QUERY_RESULT_64_BIT);
+
+        if (result == VK_SUCCESS)
+        {
+            OverdrawSample sample = { 0, pendingPixels[frame] };
+
+            for (size_t i = 0; i < scopes.size(); i++)
+            {
+                auto [entry, inserted] = history.try_emplace(scopes[i].name);
+
+                if (inserted)
+                    scopeOrder.push_back(scopes[i].name);
+
+                entry->second.last = results[i];
+                entry->second.total += results[i];
+                entry->second.samples++;
+
+                sample.fragmentInvocations += results[i].fragmentInvocations;
+            }
+
+            last = sample;
+
+            total.fragmentInvocations += last.fragmentInvocations;
+            total.pixels += last.pixels;
+            frames++;
+        }
+
+        scopes.clear();
+    }
+
+    void Reset(VkCommandBuffer commandBuffer, size_t frame, VkExtent2D extent)
+    {
+        currentFrame = static_cast<uint32_t>(frame);
+        scopeOpen = false;
+
+        if (!Active())
+            return;
+
+        pendingPixels[frame] = (uint64_t)extent.width * extent.height;
+
+        vkCmdResetQueryPool(commandBuffer, queryPools[frame], 0, MAX_STATISTICS_SCOPES);
+    }
+
+    void BeginScope(VkCommandBuffer commandBuffer, const std::string& name)
+    {
+        if (!Active() || scopeOpen || frameScopes[currentFrame].size() >= MAX_STATISTICS_SCOPES)
+            return;
+
+        std::vector<PipelineStatisticsScope>& scopes = frameScopes[currentFrame];
+
+        scopes.push_back({ name, static_cast<uint32_t>(scopes.size()) });
+        scopeOpen = true;
+
+        vkCmdBeginQuery(commandBuffer, queryPools[currentFrame], scopes.back().query, 0);
+    }
+
+    void EndScope(VkCommandBuffer commandBuffer)
+    {
+        if (!Active() || !scopeOpen)
+            return;
+
+        vkCmdEndQuery(commandBuffer, queryPools[currentFrame], frameScopes[currentFrame].back().query);
+
+        scopeOpen = false;
+    }
+
+    PipelineCounterHistory GetCounters(const std::string& name)
+    {
+        auto found = history.find(name);
+
+        return found != history.end() ? found->second : PipelineCounterHistory{};
+    }
+
+    void ResetTotals()
+    {
+        for (auto& [name, entry] : history)
+            entry = {};
+
+        total = {};
+        frames = 0;
+    }
+
+    void LogSummary()
+    {
+        if (!Active() || frames == 0)
+            return;
+
+        for (const auto& name : scopeOrder)
+        {
+            const PipelineCounterHistory& entry = history[name];
+
+            Logger_WriteConsole(std::format("Pass {}: {:.0f} vertices, {:.0f} primitives, {:.0f} vertex invocations, {:.0f} clipped primitives, {:.0f} fragment invocations, {:.0f} compute invocations per frame", name,
+                entry.Average(&PipelineCounters::inputVertices), entry.Average(&PipelineCounters::inputPrimitives), entry.Average(&PipelineCounters::vertexInvocations),
+                entry.Average(&PipelineCounters::clippingPrimitives), entry.Average(&PipelineCounters::fragmentInvocations), entry.Average(&PipelineCounters::computeInvocations)), LogLevel::INFO);
+        }
+
+        Logger_WriteConsole(std::format("Overdraw over {} frames: {:.2f}x average, {:.2f}x last frame ({} fragment invocations)", frames, total.GetOverdraw(), last.GetOverdraw(), last.fragmentInvocations), LogLevel::INFO);
+    }
+
+    void CleanUp()
+    {
+        for (VkQueryPool pool : queryPools)
+            vkDestroyQueryPool(device, pool, VULKAN_ALLOCATOR);
+
+        queryPools.clear();
+        frameScopes.clear();
+        pendingPixels.clear();
+    }
+}
+
+#endif // !PIPELINE_STATISTICS_HPP
@@ -0,0 +1,152 @@
+#ifndef PRESENT_WAIT_HPP
+#define PRESENT_WAIT_HPP
+
+#include <array>
+#include <chrono>
+#include <format>
+#include <algorithm>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core/Logger.hpp"
+#include "core/FrameStatistics.hpp"
+#include "core/Profiler.hpp"
+#include "util/VulkanHelper.hpp"
+
+#define PRESENT_WAIT_HISTORY 16
+#define PRESENT_WAIT_TIMEOUT_NS 100000000ull
+
+namespace PresentWait
+{
+    bool supported = false;
+
+    VkDevice device;
+    PFN_vkWaitForPresentKHR waitForPresent = nullptr;
+
+    // Ids are per swapchain, a new swapchain starts counting from 1 again
+    uint64_t presentId = 0;
+    uint64_t completedId = 0;
+
+    std::array<std::chrono::steady_clock::time_point, PRESENT_WAIT_HISTORY> presentTimes = {};
+
+    VkPresentIdKHR presentIdInformation = { VK_STRUCTURE_TYPE_PRESENT_ID_KHR, nullptr, 1, nullptr };
+
+    uint64_t samples = 0;
+    double totalLatency = 0.0;
+    float maxLatency = 0.0f;
+    uint64_t timeouts = 0;
+
+    bool Select(VkPhysicalDevice physicalDevice, uint32_t deviceVersion)
+    {
+        supported = false;
+
+        if (deviceVersion < VK_API_VERSION_1_1 || !VulkanHelper::HasDeviceExtension(physicalDevice, VK_KHR_PRESENT_ID_EXTENSION_NAME) || !VulkanHelper::HasDeviceExtension(physicalDevice, VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+            return false;
+
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures = {};
+        presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = {};
+        presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+        presentWaitFeatures.pNext = &presentIdFeatures;
+
+        VkPhysicalDeviceFeatures2 features = {};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &presentWaitFeatures;
+
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+        supported = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+
+        return supported;
+    }
+
+    void Initialize(VkDevice device)
+    {
+        PresentWait::device = device;
+
+        if (!supported)
+        {
+            Logger_WriteConsole("VK_KHR_present_wait is unavailable, present latency will not be measured or bounded", LogLevel::INFO);
+            return;
+        }
+
+        waitForPresent = (PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr(device, "vkWaitForPresentKHR");
+
+        if (waitForPresent == nullptr)
+            supported = false;
+    }
+
+    void Reset()
+    {
+        presentId = 0;
+        completedId = 0;
+    }
+
+    const void* GetPresentInfo()
+    {
+        if (!supported)
+            return nullptr;
+
+        presentId++;
+        presentTimes[presentId % PRESENT_WAIT_HISTORY] = std::chrono::steady_clock::now();
+
+        presentIdInformation.pPresentIds = &presentId;
+
+        return &presentIdInformation;
+    }
+
+    void Complete(uint64_t id)
+    {
+        auto now = std::chrono::steady_clock::now();
+
+        for (uint64_t i = completedId + 1; i <= id; i++)
+        {
+            if (id - i >= PRESENT_WAIT_HISTORY)
+                continue;
+
+            float latency = std::chrono::duration<float, std::milli>(now - presentTimes[i % PRESENT_WAIT_HISTORY]).count();
+
+            samples++;
+            totalLatency += latency;
+            maxLatency = std::max(maxLatency, latency);
+        }
+
+        completedId = std::max(completedId, id);
+    }
+
+    void Update(VkSwapchainKHR swapChain, uint32_t maxLatency)
+    {
+        if (!supported || presentId == completedId)
+            return;
+
+        while (completedId < presentId && waitForPresent(device, swapChain, completedId + 1, 0) == VK_SUCCESS)
+            Complete(completedId + 1);
+
+        if (maxLatency == 0 || presentId < maxLatency || presentId - maxLatency < completedId)
+            return;
+
+        uint64_t target = presentId - maxLatency + 1;
+
+        TERRA_PROFILE_SCOPE("WaitForPresent");
+        FrameWaitScope wait;
+
+        VkResult result = waitForPresent(device, swapChain, target, PRESENT_WAIT_TIMEOUT_NS);
+
+        if (result == VK_SUCCESS)
+            Complete(target);
+        else if (result == VK_TIMEOUT)
+            timeouts++;
+    }
+
+    void LogSummary()
+    {
+        if (samples == 0)
+            return;
+
+        Logger_WriteConsole(std::format("Present to display: {:.2f} ms average, {:.2f} ms worst over {} frames, {} waits timed out", totalLatency / samples, maxLatency, samples, timeouts), LogLevel::INFO);
+    }
+}
+
+#endif // !PRESENT_WAIT_HPP
@@ -0,0 +1,237 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <format>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+#include "core/Logger.hpp"
+
+#define PROFILER_RING_SIZE 16384
+#define PROFILER_DEFAULT_PATH "cache/profile.json"
+
+// Scope names must outlive the capture, pass string literals
+#ifdef TERRA_PROFILE
+#define TERRA_PROFILE_CONCAT_INNER(a, b) a##b
+#define TERRA_PROFILE_CONCAT(a, b) TERRA_PROFILE_CONCAT_INNER(a, b)
+#define TERRA_PROFILE_SCOPE(name) ProfileScope TERRA_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define TERRA_PROFILE_FUNCTION() TERRA_PROFILE_SCOPE(__FUNCTION__)
+#define TERRA_PROFILE_THREAD(name) Profiler::SetThreadName(name)
+#else
+#define TERRA_PROFILE_SCOPE(name) ((void)0)
+#define TERRA_PROFILE_FUNCTION() ((void)0)
+#define TERRA_PROFILE_THREAD(name) ((void)0)
+#endif
+
+struct ProfileEvent
+{
+    const char* name = nullptr;
+    uint64_t begin = 0;
+    uint64_t end = 0;
+    uint32_t depth = 0;
+};
+
+struct ProfileThreadBuffer
+{
+    std::array<ProfileEvent, PROFILER_RING_SIZE> events = {};
+    std::atomic<uint64_t> head = 0;
+
+    uint32_t id = 0;
+    uint32_t depth = 0;
+    std::string name = "";
+};
+
+namespace Profiler
+{
+    std::vector<std::unique_ptr<ProfileThreadBuffer>> threads;
+    std::mutex threadMutex;
+    thread_local ProfileThreadBuffer* threadBuffer = nullptr;
+
+    std::atomic<bool> recording = false;
+    uint32_t captureFrames = 0;
+    uint64_t captureStart = 0;
+    std::string capturePath = PROFILER_DEFAULT_PATH;
+
+    uint64_t Now()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    ProfileThreadBuffer& GetThreadBuffer()
+    {
+        if (threadBuffer != nullptr)
+            return *threadBuffer;
+
+        std::lock_guard<std::mutex> lock(threadMutex);
+
+        threads.push_back(std::make_unique<ProfileThreadBuffer>());
+        threadBuffer = threads.back().get();
+        threadBuffer->id = static_cast<uint32_t>(threads.size());
+        threadBuffer->name = std::format("Thread {}", threadBuffer->id);
+
+        return *threadBuffer;
+    }
+
+    void SetThreadName(const std::string& name)
+    {
+        ProfileThreadBuffer& buffer = GetThreadBuffer();
+
+        std::lock_guard<std::mutex> lock(threadMutex);
+        buffer.name = name;
+    }
+
+    void Record(ProfileThreadBuffer& buffer, const char* name, uint64_t begin, uint64_t end, uint32_t depth)
+    {
+        uint64_t head = buffer.head.load(std::memory_order_relaxed);
+
+        buffer.events[head % PROFILER_RING_SIZE] = { name, begin, end, depth };
+        buffer.head.store(head + 1, std::memory_order_release);
+    }
+
+    std::string Escape(const char* text)
+    {
+        std::string escaped;
+
+        for (const char* character = text; *character != '\0'; character++)
+        {
+            if (*character == '"' || *character == '\\')
+                escaped += '\\';
+            else if ((unsigned char)*character < 0x20)
+            {
+                escaped += std::format("\\u{:04x}", (int)*character);
+                continue;
+            }
+
+            escaped += *character;
+        }
+
+        return escaped;
+    }
+
+    void Export(const std::string& path, uint64_t start, uint64_t end)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+        std::ofstream file(path, std::ios::trunc);
+
+        if (!file.is_open())
+        {
+            Logger_WriteConsole("Could not write profile capture to " + path, LogLevel::WARNING);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(threadMutex);
+
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        bool first = true;
+        size_t written = 0;
+
+        for (const auto& thread : threads)
+        {
+            file << std::format("{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}", first ? "" : ",", thread->id, Escape(thread->name.c_str()));
+            first = false;
+
+            uint64_t head = thread->head.load(std::memory_order_acquire);
+            uint64_t oldest = head > PROFILER_RING_SIZE ? head - PROFILER_RING_SIZE : 0;
+
+            std::vector<ProfileEvent> events;
+            events.reserve((size_t)(head - oldest));
+
+            for (uint64_t index = oldest; index < head; index++)
+                events.push_back(thread->events[index % PROFILER_RING_SIZE]);
+
+            uint64_t after = thread->head.load(std::memory_order_acquire) + 1;
+            size_t torn = (size_t)std::min<uint64_t>(after > oldest + PROFILER_RING_SIZE ? after - oldest - PROFILER_RING_SIZE : 0, events.size());
+
+            for (size_t i = torn; i < events.size(); i++)
+            {
+                const ProfileEvent& event = events[i];
+
+                if (event.name == nullptr || event.begin < start || event.end > end)
+                    continue;
+
+                file << std::format(",{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}", Escape(event.name), thread->id,
+                    (event.begin - start) / 1000.0, (event.end - event.begin) / 1000.0);
+
+                written++;
+            }
+        }
+
+        file << "]}\n";
+
+        Logger_WriteConsole(std::format("Wrote {} profile events to {}", written, path), LogLevel::INFO);
+    }
+
+    void Capture(uint32_t frames, const std::string& path = PROFILER_DEFAULT_PATH)
+    {
+#ifdef TERRA_PROFILE
+        if (frames == 0 || recording.load())
+            return;
+
+        captureFrames = frames;
+        capturePath = path;
+        captureStart = Now();
+
+        recording.store(true, std::memory_order_release);
+#else
+        Logger_WriteConsole("Profiler scopes are compiled out, define TERRA_PROFILE to capture", LogLevel::WARNING);
+#endif
+    }
+
+    bool Capturing()
+    {
+        return recording.load(std::memory_order_relaxed);
+    }
+
+    void EndFrame()
+    {
+        if (!Capturing() || --captureFrames > 0)
+            return;
+
+        recording.store(false, std::memory_order_release);
+
+        Export(capturePath, captureStart, Now());
+    }
+}
+
+struct ProfileScope
+{
+    const char* name = nullptr;
+    uint64_t begin = 0;
+
+    ProfileScope(const char* name)
+    {
+        if (!Profiler::Capturing())
+            return;
+
+        this->name = name;
+        begin = Profiler::Now();
+        Profiler::GetThreadBuffer().depth++;
+    }
+
+    ~ProfileScope()
+    {
+        if (name == nullptr)
+            return;
+
+        ProfileThreadBuffer& buffer = Profiler::GetThreadBuffer();
+
+        buffer.depth--;
+        Profiler::Record(buffer, name, begin, Profiler::Now(), buffer.depth);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#endif // !PROFILER_HPP
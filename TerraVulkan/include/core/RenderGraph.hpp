@@ -0,0 +1,504 @@
+#ifndef RENDER_GRAPH_HPP
+#define RENDER_GRAPH_HPP
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <format>
+#include <algorithm>
+#include <functional>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core/Logger.hpp"
+
+#define INVALID_RENDER_RESOURCE UINT32_MAX
+#define RENDER_GRAPH_WRITE_ACCESS (VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT)
+
+typedef uint32_t RenderResourceHandle;
+
+enum class RenderResourceUsage : uint8_t
+{
+    COLOR_ATTACHMENT,
+    DEPTH_ATTACHMENT,
+    DEPTH_READ,
+    SAMPLED
+};
+
+struct RenderResourceState
+{
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkPipelineStageFlags stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    VkAccessFlags access = 0;
+};
+
+struct RenderResource
+{
+    std::string name = "";
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent = {};
+    VkImageUsageFlags usage = 0;
+
+    bool imported = false;
+    VkImage image = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    RenderResourceState initialState = {};
+    VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    uint32_t firstUse = UINT32_MAX;
+    uint32_t lastUse = 0;
+};
+
+struct RenderPassAccess
+{
+    RenderResourceHandle resource = INVALID_RENDER_RESOURCE;
+    RenderResourceUsage usage = RenderResourceUsage::SAMPLED;
+
+    bool write = false;
+    bool clear = false;
+    VkClearValue clearValue = {};
+};
+
+struct RenderGraphBarrier
+{
+    RenderResourceHandle resource = INVALID_RENDER_RESOURCE;
+
+    VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkImageLayout newLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkPipelineStageFlags sourceStage = 0;
+    VkPipelineStageFlags destinationStage = 0;
+    VkAccessFlags sourceAccess = 0;
+    VkAccessFlags destinationAccess = 0;
+};
+
+struct RenderAttachment
+{
+    RenderResourceHandle resource = INVALID_RENDER_RESOURCE;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+
+    VkAttachmentLoadOp load = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    VkAttachmentStoreOp store = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkClearValue clearValue = {};
+
+    bool depth = false;
+};
+
+struct RenderGraphPass
+{
+    std::string name = "";
+    std::function<void(VkCommandBuffer)> execute = nullptr;
+    std::vector<RenderPassAccess> accesses = {};
+    bool sideEffects = false;
+
+    bool culled = false;
+    std::vector<RenderGraphBarrier> barriers = {};
+    std::vector<RenderAttachment> attachments = {};
+    VkExtent2D extent = {};
+
+    RenderGraphPass& Read(RenderResourceHandle resource, RenderResourceUsage usage)
+    {
+        accesses.push_back({ resource, usage, false, false });
+        return *this;
+    }
+
+    RenderGraphPass& Write(RenderResourceHandle resource, RenderResourceUsage usage)
+    {
+        accesses.push_back({ resource, usage, true, false });
+        return *this;
+    }
+
+    RenderGraphPass& Clear(RenderResourceHandle resource, RenderResourceUsage usage, VkClearValue clearValue)
+    {
+        accesses.push_back({ resource, usage, true, true, clearValue });
+        return *this;
+    }
+
+    RenderGraphPass& SetSideEffects()
+    {
+        sideEffects = true;
+        return *this;
+    }
+};
+
+struct RenderAliasRequest
+{
+    uint32_t firstUse = 0;
+    uint32_t lastUse = 0;
+
+    VkDeviceSize size = 0;
+    VkDeviceSize alignment = 1;
+    uint32_t memoryTypeBits = UINT32_MAX;
+};
+
+struct RenderAliasSlot
+{
+    VkDeviceSize size = 0;
+    VkDeviceSize alignment = 1;
+    uint32_t memoryTypeBits = UINT32_MAX;
+
+    std::vector<std::pair<uint32_t, uint32_t>> lifetimes = {};
+};
+
+namespace TransientAliasing
+{
+    std::vector<uint32_t> Assign(const std::vector<RenderAliasRequest>& requests, std::vector<RenderAliasSlot>& slots)
+    {
+        std::vector<uint32_t> order(requests.size());
+        std::vector<uint32_t> assignment(requests.size(), UINT32_MAX);
+
+        for (uint32_t i = 0; i < order.size(); i++)
+            order[i] = i;
+
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return requests[a].size > requests[b].size; });
+
+        for (uint32_t index : order)
+        {
+            const RenderAliasRequest& request = requests[index];
+
+            for (uint32_t slot = 0; slot < slots.size() && assignment[index] == UINT32_MAX; slot++)
+            {
+                RenderAliasSlot& candidate = slots[slot];
+
+                if ((candidate.memoryTypeBits & request.memoryTypeBits) == 0)
+                    continue;
+
+                bool overlaps = std::any_of(candidate.lifetimes.begin(), candidate.lifetimes.end(), [&](const std::pair<uint32_t, uint32_t>& lifetime)
+                {
+                    return request.firstUse <= lifetime.second && lifetime.first <= request.lastUse;
+                });
+
+                if (overlaps)
+                    continue;
+
+                candidate.size = std::max(candidate.size, request.size);
+                candidate.alignment = std::max(candidate.alignment, request.alignment);
+                candidate.memoryTypeBits &= request.memoryTypeBits;
+                candidate.lifetimes.push_back({ request.firstUse, request.lastUse });
+
+                assignment[index] = slot;
+            }
+
+            if (assignment[index] == UINT32_MAX)
+            {
+                assignment[index] = static_cast<uint32_t>(slots.size());
+                slots.push_back({ request.size, request.alignment, request.memoryTypeBits, { { request.firstUse, request.lastUse } } });
+            }
+        }
+
+        return assignment;
+    }
+}
+
+struct RenderGraph
+{
+    std::vector<RenderResource> resources;
+    std::deque<RenderGraphPass> passes;
+
+    std::vector<uint32_t> order;
+    std::vector<RenderGraphBarrier> finalBarriers;
+
+    RenderResourceHandle CreateImage(const std::string& name, VkFormat format, VkExtent2D extent)
+    {
+        RenderResource resource = {};
+
+        resource.name = name;
+        resource.format = format;
+        resource.extent = extent;
+
+        resources.push_back(resource);
+
+        return static_cast<RenderResourceHandle>(resources.size() - 1);
+    }
+
+    RenderResourceHandle ImportImage(const std::string& name, VkFormat format, VkExtent2D extent, VkImage image, VkImageView view, const RenderResourceState& initialState, VkImageLayout finalLayout)
+    {
+        RenderResourceHandle handle = CreateImage(name, format, extent);
+        RenderResource& resource = resources[handle];
+
+        resource.imported = true;
+        resource.image = image;
+        resource.view = view;
+        resource.initialState = initialState;
+        resource.finalLayout = finalLayout;
+
+        return handle;
+    }
+
+    RenderGraphPass& AddPass(const std::string& name, const std::function<void(VkCommandBuffer)>& execute)
+    {
+        RenderGraphPass& pass = passes.emplace_back();
+
+        pass.name = name;
+        pass.execute = execute;
+
+        return pass;
+    }
+
+    const RenderGraphPass* FindPass(const std::string& name) const
+    {
+        auto found = std::find_if(passes.begin(), passes.end(), [&](const RenderGraphPass& pass) { return pass.name == name; });
+
+        return found != passes.end() ? &*found : nullptr;
+    }
+
+    static bool IsDepthFormat(VkFormat format)
+    {
+        return format == VK_FORMAT_D16_UNORM || format == VK_FORMAT_X8_D24_UNORM_PACK32 || format == VK_FORMAT_D32_SFLOAT ||
+            format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+    }
+
+    static RenderResourceState GetState(RenderResourceUsage usage, bool write)
+    {
+        switch (usage)
+        {
+        case RenderResourceUsage::COLOR_ATTACHMENT:
+            return { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | (write ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : 0u) };
+
+        case RenderResourceUsage::DEPTH_ATTACHMENT:
+            return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | (write ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : 0u) };
+
+        case RenderResourceUsage::DEPTH_READ:
+            return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT };
+
+        default:
+            return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT };
+        }
+    }
+
+    static VkImageUsageFlags GetImageUsage(RenderResourceUsage usage)
+    {
+        switch (usage)
+        {
+        case RenderResourceUsage::COLOR_ATTACHMENT:
+            return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+        case RenderResourceUsage::DEPTH_ATTACHMENT:
+        case RenderResourceUsage::DEPTH_READ:
+            return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+        default:
+            return VK_IMAGE_USAGE_SAMPLED_BIT;
+        }
+    }
+
+    static bool IsAttachment(RenderResourceUsage usage)
+    {
+        return usage != RenderResourceUsage::SAMPLED;
+    }
+
+    void Cull()
+    {
+        std::vector<bool> needed(resources.size(), false);
+
+        for (size_t i = 0; i < resources.size(); i++)
+            needed[i] = resources[i].imported;
+
+        for (size_t index = passes.size(); index-- > 0;)
+        {
+            RenderGraphPass& pass = passes[index];
+
+            pass.culled = !pass.sideEffects && std::none_of(pass.accesses.begin(), pass.accesses.end(), [&](const RenderPassAccess& access)
+            {
+                return access.write && needed[access.resource];
+            });
+
+            if (pass.culled)
+                continue;
+
+            for (const auto& access : pass.accesses)
+            {
+                if (access.write && access.clear && !resources[access.resource].imported)
+                    needed[access.resource] = false;
+            }
+
+            for (const auto& access : pass.accesses)
+            {
+                if (!access.write || !access.clear)
+                    needed[access.resource] = true;
+            }
+        }
+    }
+
+    bool Compile()
+    {
+        for (const auto& pass : passes)
+        {
+            for (const auto& access : pass.accesses)
+            {
+                if (access.resource >= resources.size())
+                {
+                    Logger_ThrowError("RENDER_GRAPH", std::format("Pass '{}' accesses an unknown resource", pass.name), false);
+                    return false;
+                }
+            }
+        }
+
+        Cull();
+
+        order.clear();
+        finalBarriers.clear();
+
+        for (uint32_t index = 0; index < passes.size(); index++)
+        {
+            if (!passes[index].culled)
+                order.push_back(index);
+        }
+
+        for (auto& resource : resources)
+        {
+            resource.firstUse = UINT32_MAX;
+            resource.lastUse = 0;
+        }
+
+        for (uint32_t position = 0; position < order.size(); position++)
+        {
+            for (const auto& access : passes[order[position]].accesses)
+            {
+                RenderResource& resource = resources[access.resource];
+
+                resource.firstUse = std::min(resource.firstUse, position);
+                resource.lastUse = std::max(resource.lastUse, position);
+                resource.usage |= GetImageUsage(access.usage);
+            }
+        }
+
+        // Transients share memory across aliases and frames, so their first barrier waits on every stage any transient is touched in
+        VkPipelineStageFlags transientStages = 0;
+        VkAccessFlags transientAccess = 0;
+
+        for (uint32_t index : order)
+        {
+            for (const auto& access : passes[index].accesses)
+            {
+                if (resources[access.resource].imported)
+                    continue;
+
+                RenderResourceState state = GetState(access.usage, access.write);
+
+                transientStages |= state.stage;
+                transientAccess |= state.access & RENDER_GRAPH_WRITE_ACCESS;
+            }
+        }
+
+        std::vector<RenderResourceState> states(resources.size());
+        std::vector<bool> hasContents(resources.size(), false);
+
+        for (size_t i = 0; i < resources.size(); i++)
+        {
+            if (resources[i].imported)
+            {
+                states[i] = resources[i].initialState;
+                hasContents[i] = resources[i].initialState.layout != VK_IMAGE_LAYOUT_UNDEFINED;
+            }
+            else
+                states[i] = { VK_IMAGE_LAYOUT_UNDEFINED, transientStages != 0 ? transientStages : (VkPipelineStageFlags)VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, transientAccess };
+        }
+
+        for (uint32_t position = 0; position < order.size(); position++)
+        {
+            RenderGraphPass& pass = passes[order[position]];
+
+            pass.barriers.clear();
+            pass.attachments.clear();
+            pass.extent = {};
+
+            std::vector<RenderPassAccess> merged;
+
+            for (const auto& access : pass.accesses)
+            {
+                auto existing = std::find_if(merged.begin(), merged.end(), [&](const RenderPassAccess& other) { return other.resource == access.resource; });
+
+                if (existing == merged.end())
+                {
+                    merged.push_back(access);
+                    continue;
+                }
+
+                if (GetState(existing->usage, false).layout != GetState(access.usage, false).layout)
+                {
+                    Logger_ThrowError("RENDER_GRAPH", std::format("Pass '{}' uses '{}' in two different layouts", pass.name, resources[access.resource].name), false);
+                    return false;
+                }
+
+                existing->write |= access.write;
+                existing->clear |= access.clear;
+
+                if (access.clear)
+                    existing->clearValue = access.clearValue;
+            }
+
+            for (const auto& access : merged)
+            {
+                RenderResource& resource = resources[access.resource];
+                RenderResourceState& current = states[access.resource];
+                RenderResourceState target = GetState(access.usage, access.write);
+
+                VkImageLayout oldLayout = access.clear ? VK_IMAGE_LAYOUT_UNDEFINED : current.layout;
+                bool hazard = (current.access & RENDER_GRAPH_WRITE_ACCESS) != 0 || (access.write && current.access != 0);
+
+                if (current.layout != target.layout || oldLayout != target.layout || hazard)
+                    pass.barriers.push_back({ access.resource, oldLayout, target.layout, current.stage, target.stage, current.access & RENDER_GRAPH_WRITE_ACCESS, target.access });
+
+                if (IsAttachment(access.usage))
+                {
+                    RenderAttachment attachment = {};
+
+                    bool readLater = resource.imported || resource.lastUse > position;
+
+                    attachment.resource = access.resource;
+                    attachment.format = resource.format;
+                    attachment.layout = target.layout;
+                    attachment.clearValue = access.clearValue;
+                    attachment.depth = IsDepthFormat(resource.format);
+                    attachment.load = access.clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : hasContents[access.resource] ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+                    attachment.store = readLater && (access.write || hasContents[access.resource]) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+                    if (pass.attachments.empty())
+                        pass.extent = resource.extent;
+
+                    pass.attachments.push_back(attachment);
+                }
+
+                current = target;
+
+                if (access.write)
+                    hasContents[access.resource] = true;
+            }
+
+            // Depth goes last so colour attachment indices match their shader output locations
+            std::stable_partition(pass.attachments.begin(), pass.attachments.end(), [](const RenderAttachment& attachment) { return !attachment.depth; });
+        }
+
+        for (RenderResourceHandle handle = 0; handle < resources.size(); handle++)
+        {
+            const RenderResource& resource = resources[handle];
+
+            if (!resource.imported || resource.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED || resource.finalLayout == states[handle].layout)
+                continue;
+
+            finalBarriers.push_back({ handle, states[handle].layout, resource.finalLayout, states[handle].stage, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, states[handle].access & RENDER_GRAPH_WRITE_ACCESS, 0 });
+        }
+
+        return true;
+    }
+
+    std::vector<RenderResourceHandle> GetTransients() const
+    {
+        std::vector<RenderResourceHandle> transients;
+
+        for (RenderResourceHandle handle = 0; handle < resources.size(); handle++)
+        {
+            if (!resources[handle].imported && resources[handle].firstUse != UINT32_MAX)
+                transients.push_back(handle);
+        }
+
+        return transients;
+    }
+};
+
+#endif // !RENDER_GRAPH_HPP
@@ -0,0 +1,493 @@
+#ifndef RENDER_GRAPH_EXECUTOR_HPP
+#define RENDER_GRAPH_EXECUTOR_HPP
+
+#include <vector>
+#include <format>
+#include <unordered_map>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core/AllocationTracker.hpp"
+#include "core/Logger.hpp"
+#include "core/GpuProfiler.hpp"
+#include "core/Profiler.hpp"
+#include "core/RenderGraph.hpp"
+#include "util/Hash.hpp"
+#include "util/VulkanHelper.hpp"
+
+struct TransientImage
+{
+    VkImage image = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+};
+
+namespace RenderGraphExecutor
+{
+    std::unordered_map<uint64_t, VkRenderPass> renderPasses;
+    std::unordered_map<uint64_t, VkFramebuffer> framebuffers;
+
+    std::vector<TransientImage> transients;
+    std::vector<VkDeviceMemory> transientMemory;
+    uint64_t transientKey = 0;
+
+    PFN_vkCmdBeginRendering beginRendering = nullptr;
+    PFN_vkCmdEndRendering endRendering = nullptr;
+
+    VkDevice device;
+    VkPhysicalDevice physicalDevice;
+
+    void Initialize(VkDevice device, VkPhysicalDevice physicalDevice)
+    {
+        RenderGraphExecutor::device = device;
+        RenderGraphExecutor::physicalDevice = physicalDevice;
+    }
+
+    bool UsesDynamicRendering()
+    {
+        return beginRendering != nullptr;
+    }
+
+    bool EnableDynamicRendering(bool extension)
+    {
+        beginRendering = (PFN_vkCmdBeginRendering)vkGetDeviceProcAddr(device, extension ? "vkCmdBeginRenderingKHR" : "vkCmdBeginRendering");
+        endRendering = (PFN_vkCmdEndRendering)vkGetDeviceProcAddr(device, extension ? "vkCmdEndRenderingKHR" : "vkCmdEndRendering");
+
+        if (beginRendering == nullptr || endRendering == nullptr)
+        {
+            beginRendering = nullptr;
+            endRendering = nullptr;
+        }
+
+        return UsesDynamicRendering();
+    }
+
+    VkImageAspectFlags GetAspect(VkFormat format)
+    {
+        if (!RenderGraph::IsDepthFormat(format))
+            return VK_IMAGE_ASPECT_COLOR_BIT;
+
+        if (format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT)
+            return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+
+        return VK_IMAGE_ASPECT_DEPTH_BIT;
+    }
+
+    VkRenderPass GetRenderPass(const std::vector<RenderAttachment>& attachments)
+    {
+        uint64_t hash = HASH_FNV_OFFSET;
+
+        for (const auto& attachment : attachments)
+        {
+            hash = Hash::Combine(hash, attachment.format);
+            hash = Hash::Combine(hash, attachment.load);
+            hash = Hash::Combine(hash, attachment.store);
+            hash = Hash::Combine(hash, attachment.layout);
+        }
+
+        auto found = renderPasses.find(hash);
+
+        if (found != renderPasses.end())
+            return found->second;
+
+        std::vector<VkAttachmentDescription> descriptions;
+        std::vector<VkAttachmentReference> colorReferences;
+        VkAttachmentReference depthReference = {};
+        bool hasDepth = false;
+
+        for (uint32_t i = 0; i < attachments.size(); i++)
+        {
+            const RenderAttachment& attachment = attachments[i];
+            VkAttachmentDescription description = {};
+
+            description.format = attachment.format;
+            description.samples = VK_SAMPLE_COUNT_1_BIT;
+            description.loadOp = attachment.load;
+            description.storeOp = attachment.store;
+            description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            description.initialLayout = attachment.layout;
+            description.finalLayout = attachment.layout;
+
+            descriptions.push_back(description);
+
+            if (attachment.depth)
+            {
+                depthReference = { i, attachment.layout };
+                hasDepth = true;
+            }
+            else
+                colorReferences.push_back({ i, attachment.layout });
+        }
+
+        VkSubpassDescription subpass = {};
+
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = static_cast<uint32_t>(colorReferences.size());
+        subpass.pColorAttachments = colorReferences.data();
+        subpass.pDepthStencilAttachment = hasDepth ? &depthReference : nullptr;
+
+        VkRenderPassCreateInfo renderPassInformation = {};
+
+        renderPassInformation.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassInformation.attachmentCount = static_cast<uint32_t>(descriptions.size());
+        renderPassInformation.pAttachments = descriptions.data();
+        renderPassInformation.subpassCount = 1;
+        renderPassInformation.pSubpasses = &subpass;
+
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+
+        if (vkCreateRenderPass(device, &renderPassInformation, VULKAN_ALLOCATOR, &renderPass) != VK_SUCCESS)
+            Logger_ThrowError("VK_FAILURE", "Failed to create render graph pass!", true);
+
+        renderPasses.insert({ hash, renderPass });
+
+        return renderPass;
+    }
+
+    VkFramebuffer GetFramebuffer(VkRenderPass renderPass, const std::vector<VkImageView>& views, VkExtent2D extent)
+    {
+        uint64_t hash = Hash::Combine(HASH_FNV_OFFSET, renderPass);
+
+        for (VkImageView view : views)
+            hash = Hash::Combine(hash, view);
+
+        hash = Hash::Combine(hash, extent.width);
+        hash = Hash::Combine(hash, extent.height);
+
+        auto found = framebuffers.find(hash);
+
+        if (found != framebuffers.end())
+            return found->second;
+
+        VkFramebufferCreateInfo framebufferInformation = {};
+
+        framebufferInformation.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInformation.renderPass = renderPass;
+        framebufferInformation.attachmentCount = static_cast<uint32_t>(views.size());
+        framebufferInformation.pAttachments = views.data();
+        framebufferInformation.width = extent.width;
+        framebufferInformation.height = extent.height;
+        framebufferInformation.layers = 1;
+
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+
+        if (vkCreateFramebuffer(device, &framebufferInformation, VULKAN_ALLOCATOR, &framebuffer) != VK_SUCCESS)
+            Logger_ThrowError("VK_FAILURE", "Failed to create render graph framebuffer!", true);
+
+        framebuffers.insert({ hash, framebuffer });
+
+        return framebuffer;
+    }
+
+    // Must run whenever an imported view is destroyed, a new view can come back with the old handle
+    void ResetFramebuffers()
+    {
+        for (auto& [hash, framebuffer] : framebuffers)
+            vkDestroyFramebuffer(device, framebuffer, VULKAN_ALLOCATOR);
+
+        framebuffers.clear();
+    }
+
+    void DestroyTransients()
+    {
+        for (auto& transient : transients)
+        {
+            vkDestroyImageView(device, transient.view, VULKAN_ALLOCATOR);
+            vkDestroyImage(device, transient.image, VULKAN_ALLOCATOR);
+        }
+
+        for (VkDeviceMemory memory : transientMemory)
+            vkFreeMemory(device, memory, VULKAN_ALLOCATOR);
+
+        transients.clear();
+        transientMemory.clear();
+        transientKey = 0;
+    }
+
+    uint64_t GetTransientKey(const RenderGraph& graph, const std::vector<RenderResourceHandle>& handles)
+    {
+        uint64_t hash = HASH_FNV_OFFSET;
+
+        for (RenderResourceHandle handle : handles)
+        {
+            const RenderResource& resource = graph.resources[handle];
+
+            hash = Hash::Combine(hash, resource.format);
+            hash = Hash::Combine(hash, resource.extent.width);
+            hash = Hash::Combine(hash, resource.extent.height);
+            hash = Hash::Combine(hash, resource.usage);
+            hash = Hash::Combine(hash, resource.firstUse);
+            hash = Hash::Combine(hash, resource.lastUse);
+        }
+
+        return hash;
+    }
+
+    void CreateTransients(const RenderGraph& graph, const std::vector<RenderResourceHandle>& handles)
+    {
+        TERRA_PROFILE_FUNCTION();
+
+        vkDeviceWaitIdle(device);
+
+        DestroyTransients();
+        ResetFramebuffers();
+
+        std::vector<RenderAliasRequest> requests;
+
+        for (RenderResourceHandle handle : handles)
+        {
+            const RenderResource& resource = graph.resources[handle];
+            TransientImage& transient = transients.emplace_back();
+
+            VkImageCreateInfo imageInformation = {};
+
+            imageInformation.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            imageInformation.imageType = VK_IMAGE_TYPE_2D;
+            imageInformation.extent = { resource.extent.width, resource.extent.height, 1 };
+            imageInformation.mipLevels = 1;
+            imageInformation.arrayLayers = 1;
+            imageInformation.format = resource.format;
+            imageInformation.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInformation.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            imageInformation.usage = resource.usage;
+            imageInformation.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInformation.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+            if (vkCreateImage(device, &imageInformation, VULKAN_ALLOCATOR, &transient.image) != VK_SUCCESS)
+                Logger_ThrowError("VK_FAILURE", "Failed to create transient image '" + resource.name + "'!", true);
+
+            VkMemoryRequirements memoryRequirements;
+            vkGetImageMemoryRequirements(device, transient.image, &memoryRequirements);
+
+            requests.push_back({ resource.firstUse, resource.lastUse, memoryRequirements.size, memoryRequirements.alignment, memoryRequirements.memoryTypeBits });
+        }
+
+        std::vector<RenderAliasSlot> slots;
+        std::vector<uint32_t> assignment = TransientAliasing::Assign(requests, slots);
+
+        for (const auto& slot : slots)
+        {
+            VkMemoryAllocateInfo allocationInformation = {};
+
+            allocationInformation.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocationInformation.allocationSize = slot.size;
+
+            if (!VulkanHelper::FindMemoryType(physicalDevice, slot.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, allocationInformation.memoryTypeIndex))
+                Logger_ThrowError("VK_FAILURE", "Failed to find a memory type for transient images!", true);
+
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+
+            if (vkAllocateMemory(device, &allocationInformation, VULKAN_ALLOCATOR, &memory) != VK_SUCCESS)
+                Logger_ThrowError("VK_FAILURE", "Failed to allocate transient image memory!", true);
+
+            transientMemory.push_back(memory);
+        }
+
+        for (size_t i = 0; i < handles.size(); i++)
+        {
+            const RenderResource& resource = graph.resources[handles[i]];
+            TransientImage& transient = transients[i];
+
+            vkBindImageMemory(device, transient.image, transientMemory[assignment[i]], 0);
+
+            VkImageViewCreateInfo viewInformation = {};
+
+            viewInformation.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInformation.image = transient.image;
+            viewInformation.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInformation.format = resource.format;
+            viewInformation.subresourceRange.aspectMask = GetAspect(resource.format) & ~VK_IMAGE_ASPECT_STENCIL_BIT;
+            viewInformation.subresourceRange.levelCount = 1;
+            viewInformation.subresourceRange.layerCount = 1;
+
+            if (vkCreateImageView(device, &viewInformation, VULKAN_ALLOCATOR, &transient.view) != VK_SUCCESS)
+                Logger_ThrowError("VK_FAILURE", "Failed to create transient image view '" + resource.name + "'!", true);
+        }
+
+        Logger_WriteConsole(std::format("Render graph placed {} transient images in {} allocations", handles.size(), slots.size()), LogLevel::DEBUG);
+    }
+
+    void Prepare(RenderGraph& graph)
+    {
+        std::vector<RenderResourceHandle> handles = graph.GetTransients();
+        uint64_t key = GetTransientKey(graph, handles);
+
+        if (key != transientKey || transients.size() != handles.size())
+        {
+            CreateTransients(graph, handles);
+            transientKey = key;
+        }
+
+        for (size_t i = 0; i < handles.size(); i++)
+        {
+            graph.resources[handles[i]].image = transients[i].image;
+            graph.resources[handles[i]].view = transients[i].view;
+        }
+    }
+
+    void RecordBarriers(VkCommandBuffer commandBuffer, const RenderGraph& graph, const std::vector<RenderGraphBarrier>& barriers)
+    {
+        if (barriers.empty())
+            return;
+
+        std::vector<VkImageMemoryBarrier> imageBarriers;
+        VkPipelineStageFlags sourceStage = 0;
+        VkPipelineStageFlags destinationStage = 0;
+
+        for (const auto& barrier : barriers)
+        {
+            const RenderResource& resource = graph.resources[barrier.resource];
+            VkImageMemoryBarrier imageBarrier = {};
+
+            imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            imageBarrier.oldLayout = barrier.oldLayout;
+            imageBarrier.newLayout = barrier.newLayout;
+            imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            imageBarrier.image = resource.image;
+            imageBarrier.subresourceRange = { GetAspect(resource.format), 0, 1, 0, 1 };
+            imageBarrier.srcAccessMask = barrier.sourceAccess;
+            imageBarrier.dstAccessMask = barrier.destinationAccess;
+
+            imageBarriers.push_back(imageBarrier);
+
+            sourceStage |= barrier.sourceStage;
+            destinationStage |= barrier.destinationStage;
+        }
+
+        vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+    }
+
+    void BeginDynamicRendering(VkCommandBuffer commandBuffer, const RenderGraph& graph, const RenderGraphPass& pass)
+    {
+        std::vector<VkRenderingAttachmentInfo> colorAttachments;
+        VkRenderingAttachmentInfo depthAttachment = {};
+        bool hasDepth = false;
+
+        for (const auto& attachment : pass.attachments)
+        {
+            VkRenderingAttachmentInfo information = {};
+
+            information.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            information.imageView = graph.resources[attachment.resource].view;
+            information.imageLayout = attachment.layout;
+            information.loadOp = attachment.load;
+            information.storeOp = attachment.store;
+            information.clearValue = attachment.clearValue;
+
+            if (attachment.depth)
+            {
+                depthAttachment = information;
+                hasDepth = true;
+            }
+            else
+                colorAttachments.push_back(information);
+        }
+
+        VkRenderingInfo renderingInformation = {};
+
+        renderingInformation.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+        renderingInformation.renderArea.extent = pass.extent;
+        renderingInformation.layerCount = 1;
+        renderingInformation.colorAttachmentCount = static_cast<uint32_t>(colorAttachments.size());
+        renderingInformation.pColorAttachments = colorAttachments.data();
+        renderingInformation.pDepthAttachment = hasDepth ? &depthAttachment : nullptr;
+
+        beginRendering(commandBuffer, &renderingInformation);
+    }
+
+    void BeginRenderPass(VkCommandBuffer commandBuffer, const RenderGraph& graph, const RenderGraphPass& pass)
+    {
+        std::vector<VkImageView> views;
+        std::vector<VkClearValue> clearValues;
+
+        for (const auto& attachment : pass.attachments)
+        {
+            views.push_back(graph.resources[attachment.resource].view);
+            clearValues.push_back(attachment.clearValue);
+        }
+
+        VkRenderPass renderPass = GetRenderPass(pass.attachments);
+
+        VkRenderPassBeginInfo beginInformation = {};
+
+        beginInformation.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        beginInformation.renderPass = renderPass;
+        beginInformation.framebuffer = GetFramebuffer(renderPass, views, pass.extent);
+        beginInformation.renderArea.extent = pass.extent;
+        beginInformation.clearValueCount = static_cast<uint32_t>(clearValues.size());
+        beginInformation.pClearValues = clearValues.data();
+
+        vkCmdBeginRenderPass(commandBuffer, &beginInformation, VK_SUBPASS_CONTENTS_INLINE);
+    }
+
+    void Execute(VkCommandBuffer commandBuffer, RenderGraph& graph)
+    {
+        TERRA_PROFILE_FUNCTION();
+
+        Prepare(graph);
+
+        for (uint32_t index : graph.order)
+        {
+            RenderGraphPass& pass = graph.passes[index];
+
+            GpuProfiler::BeginScope(commandBuffer, pass.name, true);
+
+            RecordBarriers(commandBuffer, graph, pass.barriers);
+
+            if (pass.attachments.empty())
+            {
+                if (pass.execute)
+                    pass.execute(commandBuffer);
+
+                GpuProfiler::EndScope(commandBuffer);
+                continue;
+            }
+
+            if (UsesDynamicRendering())
+                BeginDynamicRendering(commandBuffer, graph, pass);
+            else
+                BeginRenderPass(commandBuffer, graph, pass);
+
+            VkViewport viewport = {};
+            viewport.width = (float)pass.extent.width;
+            viewport.height = (float)pass.extent.height;
+            viewport.maxDepth = 1.0f;
+
+            VkRect2D scissor = {};
+            scissor.extent = pass.extent;
+
+            vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+            vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+            if (pass.execute)
+                pass.execute(commandBuffer);
+
+            if (UsesDynamicRendering())
+                endRendering(commandBuffer);
+            else
+                vkCmdEndRenderPass(commandBuffer);
+
+            GpuProfiler::EndScope(commandBuffer);
+        }
+
+        RecordBarriers(commandBuffer, graph, graph.finalBarriers);
+    }
+
+    void CleanUp()
+    {
+        DestroyTransients();
+        ResetFramebuffers();
+
+        for (auto& [hash, renderPass] : renderPasses)
+            vkDestroyRenderPass(device, renderPass, VULKAN_ALLOCATOR);
+
+        renderPasses.clear();
+
+        beginRendering = nullptr;
+        endRendering = nullptr;
+    }
+}
+
+#endif // !RENDER_GRAPH_EXECUTOR_HPP
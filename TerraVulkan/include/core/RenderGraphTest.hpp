@@ -0,0 +1,168 @@
+#ifndef RENDER_GRAPH_TEST_HPP
+#define RENDER_GRAPH_TEST_HPP
+
+#include <string>
+#include <format>
+
+#include "core/Logger.hpp"
+#include "core/RenderGraph.hpp"
+
+namespace RenderGraphTest
+{
+    uint32_t failures = 0;
+
+    void Check(bool condition, const std::string& name)
+    {
+        if (condition)
+            return;
+
+        failures++;
+        Logger_WriteConsole(std::format("Render graph test failed: {}", name), LogLevel::WARNING);
+    }
+
+    const RenderGraphBarrier* FindBarrier(const std::vector<RenderGraphBarrier>& barriers, RenderResourceHandle resource)
+    {
+        for (const auto& barrier : barriers)
+        {
+            if (barrier.resource == resource)
+                return &barrier;
+        }
+
+        return nullptr;
+    }
+
+    RenderResourceHandle ImportBackBuffer(RenderGraph& graph)
+    {
+        return graph.ImportImage("backbuffer", VK_FORMAT_B8G8R8A8_SRGB, { 64, 64 }, VK_NULL_HANDLE, VK_NULL_HANDLE,
+            { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0 }, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    }
+
+    void TestCulling()
+    {
+        RenderGraph graph = {};
+
+        RenderResourceHandle backBuffer = ImportBackBuffer(graph);
+        RenderResourceHandle unused = graph.CreateImage("unused", VK_FORMAT_R8G8B8A8_UNORM, { 64, 64 });
+
+        graph.AddPass("unused", nullptr).Clear(unused, RenderResourceUsage::COLOR_ATTACHMENT, {});
+        graph.AddPass("main", nullptr).Clear(backBuffer, RenderResourceUsage::COLOR_ATTACHMENT, {});
+
+        Check(graph.Compile(), "culling graph compiles");
+        Check(graph.FindPass("unused")->culled, "pass with unread output is culled");
+        Check(!graph.FindPass("main")->culled, "pass writing an import survives");
+        Check(graph.order.size() == 1, "only the surviving pass is ordered");
+        Check(graph.GetTransients().empty(), "culled transients are not allocated");
+    }
+
+    void TestBarriers()
+    {
+        RenderGraph graph = {};
+
+        RenderResourceHandle backBuffer = ImportBackBuffer(graph);
+        RenderResourceHandle shadow = graph.CreateImage("shadow", VK_FORMAT_R16G16B16A16_SFLOAT, { 32, 32 });
+        RenderResourceHandle depth = graph.CreateImage("depth", VK_FORMAT_D32_SFLOAT, { 64, 64 });
+
+        graph.AddPass("shadow", nullptr).Clear(shadow, RenderResourceUsage::COLOR_ATTACHMENT, {});
+        graph.AddPass("main", nullptr)
+            .Read(shadow, RenderResourceUsage::SAMPLED)
+            .Clear(depth, RenderResourceUsage::DEPTH_ATTACHMENT, {})
+            .Clear(backBuffer, RenderResourceUsage::COLOR_ATTACHMENT, {});
+
+        Check(graph.Compile(), "barrier graph compiles");
+
+        const RenderGraphPass* shadowPass = graph.FindPass("shadow");
+        const RenderGraphPass* mainPass = graph.FindPass("main");
+
+        Check(shadowPass->extent.width == 32, "pass extent comes from its attachments");
+        Check(shadowPass->attachments.size() == 1 && shadowPass->attachments[0].store == VK_ATTACHMENT_STORE_OP_STORE, "transient read later is stored");
+
+        const RenderGraphBarrier* read = FindBarrier(mainPass->barriers, shadow);
+
+        Check(read != nullptr, "sampled read after a write gets a barrier");
+
+        if (read != nullptr)
+        {
+            Check(read->oldLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL && read->newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, "sampled read transitions to shader read only");
+            Check(read->sourceStage == VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT && read->destinationStage == VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, "sampled read waits on colour output");
+            Check(read->sourceAccess == VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT && read->destinationAccess == VK_ACCESS_SHADER_READ_BIT, "sampled read makes colour writes visible");
+        }
+
+        Check(mainPass->attachments.size() == 2 && mainPass->attachments.back().depth, "depth attachment goes last");
+        Check(mainPass->attachments.back().store == VK_ATTACHMENT_STORE_OP_DONT_CARE, "depth that is never read again is not stored");
+        Check(mainPass->attachments.front().load == VK_ATTACHMENT_LOAD_OP_CLEAR && mainPass->attachments.front().store == VK_ATTACHMENT_STORE_OP_STORE, "imported output is cleared and stored");
+
+        const RenderGraphBarrier* present = FindBarrier(graph.finalBarriers, backBuffer);
+
+        Check(present != nullptr && present->newLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, "imported output ends in its final layout");
+    }
+
+    void TestLayoutConflict()
+    {
+        RenderGraph graph = {};
+
+        RenderResourceHandle backBuffer = ImportBackBuffer(graph);
+
+        graph.AddPass("conflict", nullptr)
+            .Write(backBuffer, RenderResourceUsage::COLOR_ATTACHMENT)
+            .Read(backBuffer, RenderResourceUsage::SAMPLED);
+
+        Check(!graph.Compile(), "one resource in two layouts in a pass is rejected");
+    }
+
+    void TestAliasing()
+    {
+        std::vector<RenderAliasRequest> requests =
+        {
+            { 0, 1, 1024, 256, 0b011 },
+            { 2, 3, 1024, 256, 0b010 },
+            { 1, 2, 512, 256, 0b011 },
+            { 4, 4, 2048, 256, 0b100 }
+        };
+
+        std::vector<RenderAliasSlot> slots;
+        std::vector<uint32_t> assignment = TransientAliasing::Assign(requests, slots);
+
+        Check(assignment[0] == assignment[1], "non-overlapping lifetimes share memory");
+        Check(assignment[2] != assignment[0], "overlapping lifetimes get separate memory");
+        Check(assignment[3] != assignment[0] && assignment[3] != assignment[2], "incompatible memory types are not aliased");
+        Check(slots.size() == 3, "aliasing uses the fewest slots");
+        Check(slots[assignment[0]].memoryTypeBits == 0b010, "shared slot keeps only common memory types");
+    }
+
+    void TestTransientChain()
+    {
+        RenderGraph graph = {};
+
+        RenderResourceHandle backBuffer = ImportBackBuffer(graph);
+        RenderResourceHandle first = graph.CreateImage("first", VK_FORMAT_R8G8B8A8_UNORM, { 64, 64 });
+        RenderResourceHandle second = graph.CreateImage("second", VK_FORMAT_R8G8B8A8_UNORM, { 64, 64 });
+
+        graph.AddPass("first", nullptr).Clear(first, RenderResourceUsage::COLOR_ATTACHMENT, {});
+        graph.AddPass("second", nullptr).Read(first, RenderResourceUsage::SAMPLED).Clear(second, RenderResourceUsage::COLOR_ATTACHMENT, {});
+        graph.AddPass("main", nullptr).Read(second, RenderResourceUsage::SAMPLED).Clear(backBuffer, RenderResourceUsage::COLOR_ATTACHMENT, {});
+
+        Check(graph.Compile(), "transient chain compiles");
+        Check(graph.resources[first].firstUse == 0 && graph.resources[first].lastUse == 1, "lifetime spans first write to last read");
+        Check(graph.resources[second].firstUse == 1 && graph.resources[second].lastUse == 2, "lifetimes follow pass order");
+    }
+
+    int Run()
+    {
+        failures = 0;
+
+        TestCulling();
+        TestBarriers();
+        TestLayoutConflict();
+        TestAliasing();
+        TestTransientChain();
+
+        if (failures == 0)
+            Logger_WriteConsole("Render graph tests passed", LogLevel::INFO);
+        else
+            Logger_WriteConsole(std::format("{} render graph checks failed", failures), LogLevel::WARNING);
+
+        return failures == 0 ? 0 : 1;
+    }
+}
+
+#endif // !RENDER_GRAPH_TEST_HPP
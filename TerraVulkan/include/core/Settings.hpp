@@ -2,10 +2,24 @@
 #define SETTING_HPP
 
 #include <string>
+#include "core/CVar.hpp"
+
+#define SETTINGS_MAX_FRAMES_IN_FLIGHT 3
 
 namespace Settings
 {
-	std::string domain = "terravulkan";
+	inline std::string domain = "terravulkan";
+
+	inline CVar<glm::vec4> clearColor("r.clearColor", { 0.0f, 0.4f, 0.7f, 1.0f }, "Colour the back buffer is cleared to");
+	inline CVar<std::string> presentMode("r.presentMode", "mailbox", "Preferred present mode: immediate, mailbox, fifo or fifo_relaxed, falls back to fifo when unsupported");
+	inline CVar<uint32_t> swapChainImages("r.swapChainImages", 0, "Swapchain images to request, 0 for one more than the surface minimum");
+	inline CVar<uint32_t> maxFrameLatency("r.maxFrameLatency", 0, "Presents allowed to queue up before the CPU waits for the display, 0 to never wait. Needs VK_KHR_present_wait");
+	inline CVar<uint32_t> framesInFlight("r.framesInFlight", 2, "Frames the CPU may record ahead of the GPU, 1 to " + std::to_string(SETTINGS_MAX_FRAMES_IN_FLIGHT), CVAR_FLAG_STARTUP);
+
+	inline std::string GetConfigPath()
+	{
+		return "assets/" + domain + "/settings.cfg";
+	}
 }
 
-#endif // !SETTING_HPP
\ No newline at end of file
+#endif // !SETTING_HPP
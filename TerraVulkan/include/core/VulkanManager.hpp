@@ -4,11 +4,27 @@
 #include <queue>
 #include <functional>
 #include <set>
+#include <format>
+#include <algorithm>
 #include "util/VulkanHelper.hpp"
+#include "core/AllocationTracker.hpp"
 #include "core/Logger.hpp"
 #include "core/Window.hpp"
-
-#define MAX_FRAMES_IN_FLIGHT 2
+#include "core/Settings.hpp"
+#include "core/PipelineManager.hpp"
+#include "core/DescriptorAllocator.hpp"
+#include "core/FrameAllocator.hpp"
+#include "core/ImageCache.hpp"
+#include "core/PipelineStatistics.hpp"
+#include "core/PerformanceCounters.hpp"
+#include "core/PresentWait.hpp"
+#include "core/GpuProfiler.hpp"
+#include "core/Profiler.hpp"
+#include "core/FrameStatistics.hpp"
+#include "core/RenderGraph.hpp"
+#include "core/RenderGraphExecutor.hpp"
+
+#define MAX_API_VERSION VK_API_VERSION_1_3
 
 namespace VulkanManager
 {
@@ -16,6 +32,11 @@ namespace VulkanManager
 	VkDebugUtilsMessengerEXT debugMessenger;
     VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
     VkDevice device;
+    VkPhysicalDeviceFeatures enabledFeatures = {};
+    uint32_t apiVersion = VK_API_VERSION_1_0;
+    bool preferDynamicRendering = true;
+    bool dynamicRenderingEnabled = false;
+    bool dynamicRenderingExtension = false;
     VkQueue graphicsQueue;
     VkSwapchainKHR swapChain;
     std::vector<VkImage> swapChainImages;
@@ -23,19 +44,22 @@ namespace VulkanManager
     VkFormat swapChainImageFormat;
     VkExtent2D swapChainExtent;
     std::vector<VkImageView> swapChainImageViews;
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
     VkRenderPass renderPass;
-    std::vector<VkFramebuffer> swapChainFramebuffers;
+    RenderGraph frameGraph;
     VkCommandPool commandPool;
     std::vector<VkCommandBuffer> commandBuffers;
     std::vector<VkSemaphore> imageAvailableSemaphores;
     std::vector<VkSemaphore> renderFinishedSemaphores;
     std::vector<VkFence> inFlightFences;
-    std::queue<std::function<void(VkCommandBuffer)>> renderFunctions;
+    std::vector<std::function<void(VkCommandBuffer)>> renderFunctions;
     size_t currentFrame = 0;
+    uint32_t framesInFlight = 2;
+    bool swapChainDirty = false;
 
     void RequestRenderCall(std::function<void(VkCommandBuffer)> function)
 	{
-		renderFunctions.push(function);
+		renderFunctions.push_back(function);
 	}
 
     void SetupDebugMessenger() 
@@ -53,7 +77,7 @@ namespace VulkanManager
         creationInformation.pfnUserCallback = VulkanHelper::DebugCallback;
         creationInformation.pUserData = nullptr;
 
-        if (VulkanHelper::CreateDebugUtilsMessenger(instance, &creationInformation, nullptr, &debugMessenger) != VK_SUCCESS)
+        if (VulkanHelper::CreateDebugUtilsMessenger(instance, &creationInformation, VULKAN_ALLOCATOR, &debugMessenger) != VK_SUCCESS)
             Logger_ThrowError("VK_FAILURE", "Failed to set up debug messenger!", true);
     }
 
@@ -75,19 +99,114 @@ namespace VulkanManager
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
-        VkPhysicalDeviceFeatures deviceFeatures{};
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
 
-        VkDeviceCreateInfo createInfo{};
-        createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-        createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
-        createInfo.pQueueCreateInfos = queueCreateInfos.data();
-        createInfo.pEnabledFeatures = &deviceFeatures;
+        enabledFeatures = {};
+        enabledFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+        enabledFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
 
         std::vector<const char*> deviceExtensions = 
         {   
             VK_KHR_SWAPCHAIN_EXTENSION_NAME
         };
 
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+        uint32_t deviceVersion = std::min(properties.apiVersion, apiVersion);
+
+        VkPhysicalDeviceVulkan13Features vulkan13Features = {};
+        vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+        VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures = {};
+        dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
+
+        VkPhysicalDeviceFeatures2 supportedFeatures2 = {};
+        supportedFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+
+        void* featureChain = nullptr;
+        dynamicRenderingEnabled = false;
+        dynamicRenderingExtension = false;
+
+        if (preferDynamicRendering && deviceVersion >= VK_API_VERSION_1_3)
+        {
+            supportedFeatures2.pNext = &vulkan13Features;
+            vkGetPhysicalDeviceFeatures2(physicalDevice, &supportedFeatures2);
+
+            if (vulkan13Features.dynamicRendering)
+            {
+                vulkan13Features = {};
+                vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+                vulkan13Features.dynamicRendering = VK_TRUE;
+
+                featureChain = &vulkan13Features;
+                dynamicRenderingEnabled = true;
+            }
+        }
+        else if (preferDynamicRendering && deviceVersion >= VK_API_VERSION_1_2 && VulkanHelper::HasDeviceExtension(physicalDevice, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME))
+        {
+            supportedFeatures2.pNext = &dynamicRenderingFeatures;
+            vkGetPhysicalDeviceFeatures2(physicalDevice, &supportedFeatures2);
+
+            if (dynamicRenderingFeatures.dynamicRendering)
+            {
+                deviceExtensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+
+                featureChain = &dynamicRenderingFeatures;
+                dynamicRenderingEnabled = true;
+                dynamicRenderingExtension = true;
+            }
+        }
+
+        VkPhysicalDevicePerformanceQueryFeaturesKHR performanceQueryFeatures = {};
+        performanceQueryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PERFORMANCE_QUERY_FEATURES_KHR;
+
+        VkPhysicalDeviceHostQueryResetFeatures hostQueryResetFeatures = {};
+        hostQueryResetFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES;
+
+        if (PerformanceCounters::enabled && (deviceVersion < VK_API_VERSION_1_2 || !VulkanHelper::HasDeviceExtension(physicalDevice, VK_KHR_PERFORMANCE_QUERY_EXTENSION_NAME)))
+            Logger_WriteConsole("VK_KHR_performance_query is unavailable, only pipeline statistics will be collected", LogLevel::WARNING);
+        else if (PerformanceCounters::Select(instance, physicalDevice, indices.graphicsFamily.value()))
+        {
+            deviceExtensions.push_back(VK_KHR_PERFORMANCE_QUERY_EXTENSION_NAME);
+
+            hostQueryResetFeatures.hostQueryReset = VK_TRUE;
+            hostQueryResetFeatures.pNext = featureChain;
+
+            performanceQueryFeatures.performanceCounterQueryPools = VK_TRUE;
+            performanceQueryFeatures.pNext = &hostQueryResetFeatures;
+
+            featureChain = &performanceQueryFeatures;
+        }
+
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures = {};
+        presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = {};
+        presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+        if (PresentWait::Select(physicalDevice, deviceVersion))
+        {
+            deviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+            deviceExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+
+            presentIdFeatures.presentId = VK_TRUE;
+            presentIdFeatures.pNext = featureChain;
+
+            presentWaitFeatures.presentWait = VK_TRUE;
+            presentWaitFeatures.pNext = &presentIdFeatures;
+
+            featureChain = &presentWaitFeatures;
+        }
+
+        VkDeviceCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        createInfo.pNext = featureChain;
+        createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
+        createInfo.pQueueCreateInfos = queueCreateInfos.data();
+        createInfo.pEnabledFeatures = &enabledFeatures;
+
         createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
         createInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
@@ -101,10 +220,13 @@ namespace VulkanManager
         createInfo.enabledLayerCount = 0;
 #endif
 
-        if (vkCreateDevice(physicalDevice, &createInfo, nullptr, &device) != VK_SUCCESS) 
+        if (vkCreateDevice(physicalDevice, &createInfo, VULKAN_ALLOCATOR, &device) != VK_SUCCESS) 
             Logger_ThrowError("VK_FAILURE", "Failed to create logical device!", true);
 
         vkGetDeviceQueue(device, indices.graphicsFamily.value(), 0, &graphicsQueue);
+
+        Logger_WriteConsole(std::format("Vulkan {}.{} device '{}', rendering with {}", VK_API_VERSION_MAJOR(deviceVersion), VK_API_VERSION_MINOR(deviceVersion), properties.deviceName,
+            dynamicRenderingEnabled ? (dynamicRenderingExtension ? "VK_KHR_dynamic_rendering" : "dynamic rendering") : "render passes"), LogLevel::INFO);
     }
 
     void CreatePhysicalDevice()
@@ -136,10 +258,20 @@ namespace VulkanManager
         SwapChainSupportDetails swapChainSupport = VulkanHelper::GetSwapChainSupport(physicalDevice, surface);
 
         VkSurfaceFormatKHR surfaceFormat = VulkanHelper::GetSwapSurfaceFormat(swapChainSupport.formats);
-        VkPresentModeKHR presentMode = VulkanHelper::GetSwapPresentMode(swapChainSupport.presentModes);
+        std::optional<VkPresentModeKHR> preferredPresentMode = VulkanHelper::GetPresentModeByName(Settings::presentMode);
+
+        if (!preferredPresentMode.has_value())
+            Logger_WriteConsole(std::format("Unknown present mode '{}', using fifo", Settings::presentMode.Get()), LogLevel::WARNING);
+
+        VkPresentModeKHR presentMode = VulkanHelper::GetSwapPresentMode(swapChainSupport.presentModes, preferredPresentMode.value_or(VK_PRESENT_MODE_FIFO_KHR));
         VkExtent2D extent = VulkanHelper::GetSwapExtent(swapChainSupport.capabilities);
 
-        uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
+        if (preferredPresentMode.has_value() && presentMode != preferredPresentMode.value())
+            Logger_WriteConsole(std::format("Present mode '{}' is not supported by this surface, using fifo", Settings::presentMode.Get()), LogLevel::WARNING);
+
+        uint32_t imageCount = Settings::swapChainImages > 0 ? Settings::swapChainImages.Get() : swapChainSupport.capabilities.minImageCount + 1;
+        imageCount = std::max(imageCount, swapChainSupport.capabilities.minImageCount);
+
         if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount) 
             imageCount = swapChainSupport.capabilities.maxImageCount;
 
@@ -184,7 +316,7 @@ namespace VulkanManager
 
         createInfo.oldSwapchain = VK_NULL_HANDLE;
 
-        if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &swapChain) != VK_SUCCESS)
+        if (vkCreateSwapchainKHR(device, &createInfo, VULKAN_ALLOCATOR, &swapChain) != VK_SUCCESS)
             Logger_ThrowError("VK_FAILURE", "Failed to create swap chain!", true);
 
         vkGetSwapchainImagesKHR(device, swapChain, &imageCount, nullptr);
@@ -193,6 +325,10 @@ namespace VulkanManager
 
         swapChainImageFormat = surfaceFormat.format;
         swapChainExtent = extent;
+
+        PresentWait::Reset();
+
+        Logger_WriteConsole(std::format("Swapchain {}x{}, {} images, {}", extent.width, extent.height, imageCount, VulkanHelper::GetPresentModeName(presentMode)), LogLevel::INFO);
     }
 
     void CreateImageViews()
@@ -219,72 +355,53 @@ namespace VulkanManager
             creationInformation.subresourceRange.baseArrayLayer = 0;
             creationInformation.subresourceRange.layerCount = 1;
 
-            if (vkCreateImageView(device, &creationInformation, nullptr, &swapChainImageViews[i]) != VK_SUCCESS) 
+            if (vkCreateImageView(device, &creationInformation, VULKAN_ALLOCATOR, &swapChainImageViews[i]) != VK_SUCCESS) 
                 Logger_ThrowError("VK_FAILURE", "Failed to create image views!", true);
         }
 	}
 
-    void CreateRenderPass()
+    void BuildFrameGraph(RenderGraph& graph, uint32_t imageIndex)
     {
-        VkAttachmentDescription colorAttachment{};
-
-        colorAttachment.format = swapChainImageFormat;
-        colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-        colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-        VkAttachmentReference colorAttachmentReference{};
-
-        colorAttachmentReference.attachment = 0;
-        colorAttachmentReference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        graph = {};
 
-        VkSubpassDescription subpass{};
+        RenderResourceHandle backBuffer = graph.ImportImage("backbuffer", swapChainImageFormat, swapChainExtent, swapChainImages[imageIndex], swapChainImageViews[imageIndex],
+            { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0 }, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 
-        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        subpass.colorAttachmentCount = 1;
-        subpass.pColorAttachments = &colorAttachmentReference;
+        RenderResourceHandle depth = graph.CreateImage("depth", depthFormat, swapChainExtent);
 
-        VkRenderPassCreateInfo renderPassInfo{};
+        VkClearValue colorClear = {};
+        const glm::vec4& clearColor = Settings::clearColor;
+        colorClear.color = { { clearColor.r, clearColor.g, clearColor.b, clearColor.a } };
 
-        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        renderPassInfo.attachmentCount = 1;
-        renderPassInfo.pAttachments = &colorAttachment;
-        renderPassInfo.subpassCount = 1;
-        renderPassInfo.pSubpasses = &subpass;
+        VkClearValue depthClear = {};
+        depthClear.depthStencil = { DEPTH_CLEAR_VALUE, 0 };
 
-        if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS) 
-            Logger_ThrowError("VK_FAILURE", "Failed to create render pass!", true);
-	}
+        graph.AddPass("main", [](VkCommandBuffer commandBuffer)
+        {
+            for (auto& function : renderFunctions)
+                function(commandBuffer);
+        })
+        .Clear(backBuffer, RenderResourceUsage::COLOR_ATTACHMENT, colorClear)
+        .Clear(depth, RenderResourceUsage::DEPTH_ATTACHMENT, depthClear);
+    }
 
-    void CreateFramebuffers()
+    void CreateRenderPass()
     {
-        swapChainFramebuffers.resize(swapChainImageViews.size());
-
-        for (size_t i = 0; i < swapChainImageViews.size(); i++) 
+        if (RenderGraphExecutor::UsesDynamicRendering())
         {
-            VkImageView attachments[] = 
-            {
-                swapChainImageViews[i]
-            };
+            renderPass = VK_NULL_HANDLE;
+            return;
+        }
 
-            VkFramebufferCreateInfo framebufferInfo = {};
+        BuildFrameGraph(frameGraph, 0);
 
-            framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-            framebufferInfo.renderPass = renderPass;
-            framebufferInfo.attachmentCount = 1;
-            framebufferInfo.pAttachments = attachments;
-            framebufferInfo.width = swapChainExtent.width;
-            framebufferInfo.height = swapChainExtent.height;
-            framebufferInfo.layers = 1;
+        const RenderGraphPass* mainPass = frameGraph.Compile() ? frameGraph.FindPass("main") : nullptr;
 
-            if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &swapChainFramebuffers[i]) != VK_SUCCESS) 
-                Logger_ThrowError("VK_FAILURE", "Failed to create framebuffer!", true);
-        }
-    }
+        if (mainPass == nullptr || mainPass->culled)
+            Logger_ThrowError("VK_FAILURE", "Failed to compile the frame graph!", true);
+
+        renderPass = RenderGraphExecutor::GetRenderPass(mainPass->attachments);
+	}
 
     void CreateCommandPool()
     {
@@ -295,13 +412,13 @@ namespace VulkanManager
         poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
         poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
-        if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS) 
+        if (vkCreateCommandPool(device, &poolInfo, VULKAN_ALLOCATOR, &commandPool) != VK_SUCCESS) 
             Logger_ThrowError("VK_FAILURE", "Failed to create command pool!", true);
 	}
 
     void CreateCommandBuffers()
     {
-        commandBuffers.resize(swapChainFramebuffers.size());
+        commandBuffers.resize(framesInFlight);
 
         VkCommandBufferAllocateInfo allocationInformation{};
 
@@ -312,48 +429,41 @@ namespace VulkanManager
 
         if (vkAllocateCommandBuffers(device, &allocationInformation, commandBuffers.data()) != VK_SUCCESS) 
             Logger_ThrowError("VK_FAILURE", "Failed to allocate command buffers!", true);
+	}
 
-        for (size_t i = 0; i < commandBuffers.size(); i++) 
-        {
-            VkCommandBufferBeginInfo recordingInformation = {};
-            recordingInformation.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    void RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex)
+    {
+        TERRA_PROFILE_FUNCTION();
 
-            if (vkBeginCommandBuffer(commandBuffers[i], &recordingInformation) != VK_SUCCESS) 
-                Logger_ThrowError("VK_FAILURE", "Failed to begin recording command buffer!", true);
+        VkCommandBufferBeginInfo recordingInformation = {};
+        recordingInformation.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        recordingInformation.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
+        if (vkBeginCommandBuffer(commandBuffer, &recordingInformation) != VK_SUCCESS) 
+            Logger_ThrowError("VK_FAILURE", "Failed to begin recording command buffer!", true);
 
-            VkRenderPassBeginInfo renderPassInfo{};
-            renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-            renderPassInfo.renderPass = renderPass;
-            renderPassInfo.framebuffer = swapChainFramebuffers[i];
-            renderPassInfo.renderArea.offset = { 0, 0 };
-            renderPassInfo.renderArea.extent = swapChainExtent;
+        PipelineStatistics::Reset(commandBuffer, currentFrame, swapChainExtent);
+        PerformanceCounters::Reset(currentFrame);
+        GpuProfiler::Reset(commandBuffer, currentFrame);
 
-            VkClearValue clearColor = { {{0.0f, 0.4f, 0.7f, 1.0f}} };
-            renderPassInfo.clearValueCount = 1;
-            renderPassInfo.pClearValues = &clearColor;
+        GpuProfiler::BeginScope(commandBuffer, "frame");
 
-            vkCmdBeginRenderPass(commandBuffers[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        BuildFrameGraph(frameGraph, imageIndex);
 
-            while (!renderFunctions.empty())
-            {
-				renderFunctions.front()(commandBuffers[i]);
-				renderFunctions.pop();
-			}
+        if (frameGraph.Compile())
+            RenderGraphExecutor::Execute(commandBuffer, frameGraph);
 
-            vkCmdEndRenderPass(commandBuffers[i]);
+        GpuProfiler::EndScope(commandBuffer);
 
-
-            if (vkEndCommandBuffer(commandBuffers[i]) != VK_SUCCESS) 
-                Logger_ThrowError("VK_FAILURE", "Failed to record command buffer!", true);
-        }
-	}
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) 
+            Logger_ThrowError("VK_FAILURE", "Failed to record command buffer!", true);
+    }
 
     void CreateSyncObjects()
     {
-        imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-        renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-        inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+        imageAvailableSemaphores.resize(framesInFlight);
+        renderFinishedSemaphores.resize(framesInFlight);
+        inFlightFences.resize(framesInFlight);
 
         VkSemaphoreCreateInfo semaphoreInfo{};
         semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -362,25 +472,21 @@ namespace VulkanManager
         fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
         fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) 
+        for (size_t i = 0; i < framesInFlight; i++) 
         {
-            if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &imageAvailableSemaphores[i]) != VK_SUCCESS || vkCreateSemaphore(device, &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]) != VK_SUCCESS || vkCreateFence(device, &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS) 
+            if (vkCreateSemaphore(device, &semaphoreInfo, VULKAN_ALLOCATOR, &imageAvailableSemaphores[i]) != VK_SUCCESS || vkCreateSemaphore(device, &semaphoreInfo, VULKAN_ALLOCATOR, &renderFinishedSemaphores[i]) != VK_SUCCESS || vkCreateFence(device, &fenceInfo, VULKAN_ALLOCATOR, &inFlightFences[i]) != VK_SUCCESS) 
                 Logger_ThrowError("VK_FAILURE", "Failed to create synchronization objects for a frame!", true);
         }
 	}
 
     void CleanUpSwapChain() 
     {
-        for (auto framebuffer : swapChainFramebuffers) 
-            vkDestroyFramebuffer(device, framebuffer, nullptr);
-
-        vkFreeCommandBuffers(device, commandPool, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+        RenderGraphExecutor::ResetFramebuffers();
 
         for (auto imageView : swapChainImageViews) 
-            vkDestroyImageView(device, imageView, nullptr);
+            vkDestroyImageView(device, imageView, VULKAN_ALLOCATOR);
 
-        vkDestroyRenderPass(device, renderPass, nullptr);
-        vkDestroySwapchainKHR(device, swapChain, nullptr);
+        vkDestroySwapchainKHR(device, swapChain, VULKAN_ALLOCATOR);
     }
 
     void Rebuild()
@@ -389,16 +495,34 @@ namespace VulkanManager
 
         CleanUpSwapChain();
 
+        VkFormat previousFormat = swapChainImageFormat;
+
         CreateSwapChain();
         CreateImageViews();
-        CreateRenderPass();
-        CreateFramebuffers();
-        CreateCommandBuffers();
+
+        if (swapChainImageFormat != previousFormat)
+        {
+            VkRenderPass previousRenderPass = renderPass;
+
+            CreateRenderPass();
+            PipelineManager::Retarget(previousRenderPass, renderPass, previousFormat, swapChainImageFormat);
+        }
     }
 
     void PreInitialize()
     {
-        WINDOW_SIZE_CALLBACK
+        apiVersion = std::min(VulkanHelper::GetInstanceVersion(), (uint32_t)MAX_API_VERSION);
+        framesInFlight = std::clamp(Settings::framesInFlight.Get(), 1u, (uint32_t)SETTINGS_MAX_FRAMES_IN_FLIGHT);
+
+        Settings::presentMode.OnChange([](const std::string& mode)
+        {
+            swapChainDirty = true;
+        });
+
+        Settings::swapChainImages.OnChange([](const uint32_t& count)
+        {
+            swapChainDirty = true;
+        });
 
         VkApplicationInfo applicationInformation = {};
         applicationInformation.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
@@ -406,7 +530,7 @@ namespace VulkanManager
         applicationInformation.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
         applicationInformation.pEngineName = "Terracraft";
         applicationInformation.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-        applicationInformation.apiVersion = VK_API_VERSION_1_0;
+        applicationInformation.apiVersion = apiVersion;
 
         VkInstanceCreateInfo creationInformation = {};
         creationInformation.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -429,7 +553,7 @@ namespace VulkanManager
         creationInformation.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
         creationInformation.ppEnabledExtensionNames = extensions.data();
 
-        VkResult result = vkCreateInstance(&creationInformation, nullptr, &instance);
+        VkResult result = vkCreateInstance(&creationInformation, VULKAN_ALLOCATOR, &instance);
 
         if (result != VK_SUCCESS) 
         {
@@ -467,14 +591,31 @@ namespace VulkanManager
 
         CreateLogicalDeviceAndQueue();
 
+        PipelineManager::PreInitialize(device, physicalDevice);
+
+        DescriptorAllocator::Initialize(device, framesInFlight);
+        FrameAllocator::Initialize(device, physicalDevice, framesInFlight);
+        ImageCache::Initialize(device, physicalDevice, framesInFlight);
+        PipelineStatistics::Initialize(device, enabledFeatures, framesInFlight);
+        PerformanceCounters::Initialize(device, framesInFlight);
+        GpuProfiler::Initialize(device, physicalDevice, VulkanHelper::FindQueueFamilies(physicalDevice, surface).graphicsFamily.value(), framesInFlight);
+        PresentWait::Initialize(device);
+        RenderGraphExecutor::Initialize(device, physicalDevice);
+
+        if (dynamicRenderingEnabled && !RenderGraphExecutor::EnableDynamicRendering(dynamicRenderingExtension))
+            Logger_ThrowError("VK_FAILURE", "Dynamic rendering was enabled but its commands could not be loaded!", true);
+
+        depthFormat = VulkanHelper::GetDepthFormat(physicalDevice);
+
+        if (depthFormat == VK_FORMAT_UNDEFINED)
+            Logger_ThrowError("VK_FAILURE", "Failed to find a supported depth format!", true);
+
         CreateSwapChain();
 
         CreateImageViews();
 
         CreateRenderPass();
 
-        CreateFramebuffers();
-
         CreateCommandPool();
     }
 
@@ -487,14 +628,51 @@ namespace VulkanManager
 
     void Render() 
     {
-        vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+        TERRA_PROFILE_FUNCTION();
+        TERRA_ALLOCATION_SCOPE(AllocationTag::RENDERER);
+
+        FrameStatistics::BeginFrame();
+        AllocationTracker::BeginFrame();
+
+        if (Window::ConsumeResize() || swapChainDirty)
+        {
+            swapChainDirty = false;
+            Rebuild();
+        }
+
+        PresentWait::Update(swapChain, Settings::maxFrameLatency);
+
+        {
+            TERRA_PROFILE_SCOPE("WaitForFence");
+            FrameWaitScope wait;
+            vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+        }
+
         vkResetFences(device, 1, &inFlightFences[currentFrame]);
 
+        PipelineStatistics::Collect(currentFrame);
+        PerformanceCounters::Collect(currentFrame);
+        GpuProfiler::Collect(currentFrame);
+
+        DescriptorAllocator::BeginFrame(currentFrame);
+        FrameAllocator::BeginFrame(currentFrame);
+        ImageCache::BeginFrame();
+        PipelineManager::Update();
+
         uint32_t imageIndex;
-        vkAcquireNextImageKHR(device, swapChain, UINT64_MAX, imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+
+        {
+            TERRA_PROFILE_SCOPE("AcquireNextImage");
+            FrameWaitScope wait;
+            vkAcquireNextImageKHR(device, swapChain, UINT64_MAX, imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+        }
+
+        vkResetCommandBuffer(commandBuffers[currentFrame], 0);
+        RecordCommandBuffer(commandBuffers[currentFrame], imageIndex);
 
         VkSubmitInfo submitInfo{};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext = PerformanceCounters::GetSubmitInfo();
 
         VkSemaphore waitSemaphores[] = { imageAvailableSemaphores[currentFrame] };
         VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
@@ -504,17 +682,24 @@ namespace VulkanManager
         submitInfo.pWaitDstStageMask = waitStages;
 
         submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffers[imageIndex];
+        submitInfo.pCommandBuffers = &commandBuffers[currentFrame];
 
         VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[currentFrame] };
         submitInfo.signalSemaphoreCount = 1;
         submitInfo.pSignalSemaphores = signalSemaphores;
 
-        if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) 
-            Logger_ThrowError("VK_FAILURE", "Failed to submit draw command buffer!", true);
+        {
+            TERRA_PROFILE_SCOPE("QueueSubmit");
+
+            if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) 
+                Logger_ThrowError("VK_FAILURE", "Failed to submit draw command buffer!", true);
+        }
+
+        FrameStatistics::EndSubmit();
 
         VkPresentInfoKHR presentInfo{};
         presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        presentInfo.pNext = PresentWait::GetPresentInfo();
 
         presentInfo.waitSemaphoreCount = 1;
         presentInfo.pWaitSemaphores = signalSemaphores;
@@ -524,45 +709,55 @@ namespace VulkanManager
         presentInfo.pSwapchains = swapChains;
         presentInfo.pImageIndices = &imageIndex;
 
-        vkQueuePresentKHR(graphicsQueue, &presentInfo);
+        {
+            TERRA_PROFILE_SCOPE("QueuePresent");
+            FrameWaitScope wait;
+            vkQueuePresentKHR(graphicsQueue, &presentInfo);
+        }
+
+        FrameStatistics::EndFrame();
 
-        currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+        currentFrame = (currentFrame + 1) % framesInFlight;
     }
 
     void CleanUp()
     {
         vkDeviceWaitIdle(device);
 
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+        RenderGraphExecutor::CleanUp();
+        GpuProfiler::CleanUp();
+        PerformanceCounters::CleanUp();
+        PipelineStatistics::CleanUp();
+        ImageCache::CleanUp();
+        FrameAllocator::CleanUp();
+        DescriptorAllocator::CleanUp();
+        PipelineManager::CleanUp();
+
+        for (size_t i = 0; i < framesInFlight; i++)
         {
-            vkDestroySemaphore(device, renderFinishedSemaphores[i], nullptr);
-            vkDestroySemaphore(device, imageAvailableSemaphores[i], nullptr);
-            vkDestroyFence(device, inFlightFences[i], nullptr);
+            vkDestroySemaphore(device, renderFinishedSemaphores[i], VULKAN_ALLOCATOR);
+            vkDestroySemaphore(device, imageAvailableSemaphores[i], VULKAN_ALLOCATOR);
+            vkDestroyFence(device, inFlightFences[i], VULKAN_ALLOCATOR);
         }
 
         vkFreeCommandBuffers(device, commandPool, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
 
-        for (auto framebuffer : swapChainFramebuffers)
-            vkDestroyFramebuffer(device, framebuffer, nullptr);
-
-        vkDestroyRenderPass(device, renderPass, nullptr);
-
         for (auto imageView : swapChainImageViews)
-            vkDestroyImageView(device, imageView, nullptr);
+            vkDestroyImageView(device, imageView, VULKAN_ALLOCATOR);
 
-        vkDestroySwapchainKHR(device, swapChain, nullptr);
+        vkDestroySwapchainKHR(device, swapChain, VULKAN_ALLOCATOR);
         
-        vkDestroySurfaceKHR(instance, surface, nullptr);
+        vkDestroySurfaceKHR(instance, surface, VULKAN_ALLOCATOR);
 
-        vkDestroyCommandPool(device, commandPool, nullptr);
+        vkDestroyCommandPool(device, commandPool, VULKAN_ALLOCATOR);
 
-        vkDestroyDevice(device, nullptr);
+        vkDestroyDevice(device, VULKAN_ALLOCATOR);
 
 #ifdef _DEBUG
-        VulkanHelper::DestroyDebugUtilsMessenger(instance, debugMessenger, nullptr);
+        VulkanHelper::DestroyDebugUtilsMessenger(instance, debugMessenger, VULKAN_ALLOCATOR);
 #endif
 
-        vkDestroyInstance(instance, nullptr);
+        vkDestroyInstance(instance, VULKAN_ALLOCATOR);
     }
 }
 
@@ -3,33 +3,41 @@
 
 #include <string>
 #include <glm/glm.hpp>
+#include "core/AllocationTracker.hpp"
 #include "util/GL.hpp"
 
-#define WINDOW_SIZE_CALLBACK \
-    \
-	GL_WINDOW_SET_FRAMEBUFFER_SIZE_CALLBACK(Window::window, [](GLFWwindow* window, int width, int height) \
-	{ \
-		VulkanManager::Rebuild(); \
-	}); \
-
 namespace Window
 {
 	GLFWwindow* window;
 
-	void Initialize(const glm::ivec2& size, const std::string& title)
+	glm::ivec2 framebufferSize = {};
+	uint64_t resizeCount = 0;
+	bool resizePending = false;
+
+	void Initialize(const glm::ivec2& size, const std::string& title, bool visible = true)
 	{
 		GL_INIT();
 
 		GL_WINDOW_DATA(GLFW_CLIENT_API, GLFW_NO_API);
+		GL_WINDOW_DATA(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
 		window = GL_WINDOW_CREATE(size.x, size.y, title.c_str(), nullptr, nullptr);
 
+		GL_WINDOW_GET_FRAME_BUFFER_SIZE(window, &framebufferSize.x, &framebufferSize.y);
+
+		GL_WINDOW_SET_FRAMEBUFFER_SIZE_CALLBACK(window, [](GLFWwindow* window, int width, int height)
+		{
+			framebufferSize = glm::ivec2(width, height);
+			resizeCount++;
+			resizePending = true;
+		});
+
 		uint32_t extensionCount = 0;
 		vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
 	}
 
 	void GetSurface(GLFWwindow* window, VkSurfaceKHR& surface, VkInstance& instance) 
 	{
-		if (glfwCreateWindowSurface(instance, window, nullptr, &surface) != VK_SUCCESS) 
+		if (glfwCreateWindowSurface(instance, window, VULKAN_ALLOCATOR, &surface) != VK_SUCCESS) 
 			Logger_ThrowError("VK_FAILURE", "Failed to create window surface!", true);
 	}
 
@@ -52,6 +60,16 @@ namespace Window
 		return {(unsigned int)size.x, (unsigned int)size.y};
 	}
 
+	bool ConsumeResize()
+	{
+		if (!resizePending || framebufferSize.x == 0 || framebufferSize.y == 0)
+			return false;
+
+		resizePending = false;
+
+		return true;
+	}
+
 	bool ShouldClose()
 	{
 		return GL_WINDOW_SHOULD_CLOSE(window);
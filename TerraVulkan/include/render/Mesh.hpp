@@ -1,6 +1,9 @@
 #ifndef MESH_HPP
 #define MESH_HPP
 
+#include "core/AllocationTracker.hpp"
+#include "core/Profiler.hpp"
+#include "render/RenderQueue.hpp"
 #include "render/ShaderManager.hpp"
 #include "render/Vertex.hpp"
 #include "util/MeshHelper.hpp"
@@ -26,6 +29,8 @@ public:
 
 	void Generate()
 	{
+        TERRA_ALLOCATION_SCOPE(AllocationTag::MESH);
+
         GenerateVertexBuffer();
         GenerateIndexBuffer();
 	}
@@ -41,20 +46,28 @@ public:
         VkBuffer vertexBuffers[] = { vertexBuffer };
         VkDeviceSize offsets[] = { 0 };
 
+        if (!PipelineManager::Bind(commandBuffer, pipeline))
+            return;
+
         vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
         vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
         vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
     }
 
+    void Submit(float distance = 0.0f, bool opaque = true)
+    {
+        RenderQueue::Submit({ pipeline, depthPipeline, vertexBuffer, indexBuffer, static_cast<uint32_t>(indices.size()), distance, opaque });
+    }
+
     void CleanUp()
     {
-        vkDestroyBuffer(VulkanManager::device, vertexBuffer, nullptr);
-        vkFreeMemory(VulkanManager::device, vertexBufferMemory, nullptr);
-        vkDestroyBuffer(VulkanManager::device, indexBuffer, nullptr);
-        vkFreeMemory(VulkanManager::device, indexBufferMemory, nullptr);
+        vkDestroyBuffer(VulkanManager::device, vertexBuffer, VULKAN_ALLOCATOR);
+        vkFreeMemory(VulkanManager::device, vertexBufferMemory, VULKAN_ALLOCATOR);
+        vkDestroyBuffer(VulkanManager::device, indexBuffer, VULKAN_ALLOCATOR);
+        vkFreeMemory(VulkanManager::device, indexBufferMemory, VULKAN_ALLOCATOR);
     }
 
-	static Mesh Register(const std::string& name, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const std::string& shader)
+	static Mesh Register(const std::string& name, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const std::string& shader, ShaderVariantKey variant = SHADER_FEATURE_NONE)
 	{
 		Mesh mesh = {};
 
@@ -62,12 +75,18 @@ public:
 		mesh.vertices = vertices;
 		mesh.indices = indices;
 		mesh.shader = ShaderManager::Get(shader);
+		mesh.pipeline = ShaderManager::GetVariant(shader, variant);
+
+		if (RenderQueue::depthPrePass)
+			mesh.depthPipeline = ShaderManager::GetDepthVariant(shader, variant);
 
 		return mesh;
 	}
 	
 	std::string	name;
     Shader shader;
+	PipelineHandle pipeline = INVALID_PIPELINE_HANDLE;
+	PipelineHandle depthPipeline = INVALID_PIPELINE_HANDLE;
 	std::vector<Vertex> vertices;
 	std::vector<uint32_t> indices;
 
@@ -80,6 +99,8 @@ private:
 
     void GenerateVertexBuffer()
     {
+        TERRA_PROFILE_FUNCTION();
+
         VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
 
         VkBuffer stagingBuffer;
@@ -95,12 +116,14 @@ private:
 
         MeshHelper::CopyBuffer(stagingBuffer, vertexBuffer, bufferSize);
 
-        vkDestroyBuffer(VulkanManager::device, stagingBuffer, nullptr);
-        vkFreeMemory(VulkanManager::device, stagingBufferMemory, nullptr);
+        vkDestroyBuffer(VulkanManager::device, stagingBuffer, VULKAN_ALLOCATOR);
+        vkFreeMemory(VulkanManager::device, stagingBufferMemory, VULKAN_ALLOCATOR);
     }
 
     void GenerateIndexBuffer() 
     {
+        TERRA_PROFILE_FUNCTION();
+
         VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
 
         VkBuffer stagingBuffer;
@@ -116,8 +139,8 @@ private:
 
         MeshHelper::CopyBuffer(stagingBuffer, indexBuffer, bufferSize);
 
-        vkDestroyBuffer(VulkanManager::device, stagingBuffer, nullptr);
-        vkFreeMemory(VulkanManager::device, stagingBufferMemory, nullptr);
+        vkDestroyBuffer(VulkanManager::device, stagingBuffer, VULKAN_ALLOCATOR);
+        vkFreeMemory(VulkanManager::device, stagingBufferMemory, VULKAN_ALLOCATOR);
     }
 };
 
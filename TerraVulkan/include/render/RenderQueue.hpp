@@ -0,0 +1,78 @@
+#ifndef RENDER_QUEUE_HPP
+#define RENDER_QUEUE_HPP
+
+#include <vector>
+#include <algorithm>
+#include "core/PipelineManager.hpp"
+
+struct DrawCommand
+{
+    PipelineHandle pipeline = INVALID_PIPELINE_HANDLE;
+    PipelineHandle depthPipeline = INVALID_PIPELINE_HANDLE;
+
+    VkBuffer vertexBuffer = VK_NULL_HANDLE;
+    VkBuffer indexBuffer = VK_NULL_HANDLE;
+    uint32_t indexCount = 0;
+
+    float distance = 0.0f;
+    bool opaque = true;
+};
+
+namespace RenderQueue
+{
+    std::vector<DrawCommand> opaqueDraws;
+    std::vector<DrawCommand> transparentDraws;
+
+    bool depthPrePass = false;
+    bool sortFrontToBack = true;
+
+    void Submit(const DrawCommand& command)
+    {
+        if (command.opaque)
+            opaqueDraws.push_back(command);
+        else
+            transparentDraws.push_back(command);
+    }
+
+    void Draw(VkCommandBuffer commandBuffer, const DrawCommand& command, PipelineHandle pipeline)
+    {
+        if (!PipelineManager::Bind(commandBuffer, pipeline))
+            return;
+
+        VkDeviceSize offset = 0;
+
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &command.vertexBuffer, &offset);
+        vkCmdBindIndexBuffer(commandBuffer, command.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+        vkCmdDrawIndexed(commandBuffer, command.indexCount, 1, 0, 0, 0);
+    }
+
+    void Record(VkCommandBuffer commandBuffer)
+    {
+        if (sortFrontToBack)
+            std::stable_sort(opaqueDraws.begin(), opaqueDraws.end(), [](const DrawCommand& a, const DrawCommand& b) { return a.distance < b.distance; });
+        else
+            std::stable_sort(opaqueDraws.begin(), opaqueDraws.end(), [](const DrawCommand& a, const DrawCommand& b) { return a.pipeline < b.pipeline; });
+
+        std::stable_sort(transparentDraws.begin(), transparentDraws.end(), [](const DrawCommand& a, const DrawCommand& b) { return a.distance > b.distance; });
+
+        if (depthPrePass)
+        {
+            for (const auto& command : opaqueDraws)
+            {
+                if (command.depthPipeline != INVALID_PIPELINE_HANDLE)
+                    Draw(commandBuffer, command, command.depthPipeline);
+            }
+        }
+
+        for (const auto& command : opaqueDraws)
+            Draw(commandBuffer, command, command.pipeline);
+
+        for (const auto& command : transparentDraws)
+            Draw(commandBuffer, command, command.pipeline);
+
+        opaqueDraws.clear();
+        transparentDraws.clear();
+    }
+}
+
+#endif // !RENDER_QUEUE_HPP
@@ -1,15 +1,30 @@
 #ifndef SHADER_HPP
 #define SHADER_HPP
 
-#include <fstream>
+#include <array>
+#include <memory>
+#include <format>
+#include <filesystem>
 #include "core/Settings.hpp"
 #include "core/VulkanManager.hpp"
+#include "core/PipelineManager.hpp"
+#include "render/ShaderCompiler.hpp"
+#include "render/ShaderFeature.hpp"
+#include "render/ShaderModuleCache.hpp"
+#include "render/Vertex.hpp"
 
 struct ShaderStage
 {
 
 };
 
+enum class ShaderCompileState : uint8_t
+{
+    IDLE,
+    COMPILING,
+    REQUEUED
+};
+
 struct Shader
 {
 
@@ -17,26 +32,134 @@ public:
 
     void Generate()
     {
-        auto vertexShaderCode = ReadShaderFile(vertexPath);
-        auto fragmentShaderCode = ReadShaderFile(fragmentPath);
+        pipeline = GetVariant(SHADER_FEATURE_NONE);
+    }
+
+    PipelineHandle GetVariant(ShaderVariantKey key)
+    {
+        return RequestVariant(key, false);
+    }
+
+    PipelineHandle GetDepthVariant(ShaderVariantKey key)
+    {
+        return RequestVariant(key, true);
+    }
+
+    void Reload()
+    {
+        std::array<bool, SHADER_VARIANT_COUNT> queued = {};
+
+        for (ShaderVariantKey key = 0; key < SHADER_VARIANT_COUNT; key++)
+        {
+            if (variants[key] == INVALID_PIPELINE_HANDLE && depthVariants[key] == INVALID_PIPELINE_HANDLE)
+                continue;
+
+            ShaderVariantKey compiled = key & compiledFeatures;
+
+            if (compiled == SHADER_FEATURE_NONE)
+                SwapVariant(key);
+            else if (!queued[compiled])
+            {
+                queued[compiled] = true;
+                CompileVariantAsync(compiled, true);
+            }
+        }
+    }
+
+    bool CompileVariant(ShaderVariantKey key, bool force)
+    {
+        ShaderVariantKey compiled = key & compiledFeatures;
+
+        if (compiled == SHADER_FEATURE_NONE)
+            return true;
+
+        std::vector<std::string> defines = ShaderFeatures::GetDefines(compiled);
+
+        if (force)
+            return ShaderCompiler::Compile(vertexSourcePath, GetVariantPath(vertexPath, key), defines) && ShaderCompiler::Compile(fragmentSourcePath, GetVariantPath(fragmentPath, key), defines);
+
+        return ShaderCompiler::CompileIfStale(vertexSourcePath, GetVariantPath(vertexPath, key), defines) && ShaderCompiler::CompileIfStale(fragmentSourcePath, GetVariantPath(fragmentPath, key), defines);
+    }
+
+    bool IsVariantStale(ShaderVariantKey key) const
+    {
+        if ((key & compiledFeatures) == SHADER_FEATURE_NONE)
+            return false;
+
+        return ShaderCompiler::IsStale(vertexSourcePath, GetVariantPath(vertexPath, key)) || ShaderCompiler::IsStale(fragmentSourcePath, GetVariantPath(fragmentPath, key));
+    }
+
+    std::string GetVariantPath(const std::string& path, ShaderVariantKey key) const
+    {
+        ShaderVariantKey compiled = key & compiledFeatures;
+
+        if (compiled == SHADER_FEATURE_NONE)
+            return path;
+
+        return std::filesystem::path(path).replace_extension(std::format(".{}.spv", compiled)).generic_string();
+    }
+
+    void AcquireModules(ShaderVariantKey key = SHADER_FEATURE_NONE)
+    {
+        CachedShaderModule vertex = ShaderModuleCache::Acquire(GetVariantPath(vertexPath, key));
+        CachedShaderModule fragment = ShaderModuleCache::Acquire(GetVariantPath(fragmentPath, key));
+
+        ReleaseModules();
+
+        vertexShaderModule = vertex.module;
+        fragmentShaderModule = fragment.module;
+        vertexHash = vertex.hash;
+        fragmentHash = fragment.hash;
+    }
+
+    void ReleaseModules()
+    {
+        if (vertexShaderModule != VK_NULL_HANDLE)
+            ShaderModuleCache::Release(vertexHash);
+
+        if (fragmentShaderModule != VK_NULL_HANDLE)
+            ShaderModuleCache::Release(fragmentHash);
+
+        vertexShaderModule = VK_NULL_HANDLE;
+        fragmentShaderModule = VK_NULL_HANDLE;
+    }
+
+    PipelineState GetPipelineState(ShaderVariantKey key = SHADER_FEATURE_NONE, bool depthOnly = false) const
+    {
+        PipelineState state = {};
 
-        vertexShaderModule = CreateShaderModule(vertexShaderCode);
-        fragmentShaderModule = CreateShaderModule(fragmentShaderCode);
+        state.vertexHash = vertexHash;
+        state.fragmentHash = fragmentHash;
+        state.vertexShader = vertexShaderModule;
+        state.fragmentShader = fragmentShaderModule;
+        state.renderPass = VulkanManager::renderPass;
+        state.colorFormat = VulkanManager::swapChainImageFormat;
+        state.depthFormat = VulkanManager::depthFormat;
+        state.vertexBinding = Vertex::GetBindingDescription();
+        state.vertexAttributes = Vertex::GetAttributeDescriptions();
+        state.specialization = key;
+        state.depthTest = true;
+        state.depthWrite = true;
+        state.colorWrite = !depthOnly;
+
+        return state;
     }
 
     void CleanUp()
     {
-        vkDestroyShaderModule(VulkanManager::device, vertexShaderModule, nullptr);
-        vkDestroyShaderModule(VulkanManager::device, fragmentShaderModule, nullptr);
+        ReleaseModules();
     }
 
-	static Shader Register(const std::string& path, const std::string& name, const std::string& domain = Settings::domain)
+	static Shader Register(const std::string& path, const std::string& name, ShaderVariantKey compiledFeatures = SHADER_FEATURE_NONE, const std::string& domain = Settings::domain)
 	{
 		Shader shader = {};
 
 		shader.name = name;
+		shader.compiledFeatures = compiledFeatures;
 		shader.vertexPath = "assets/" + domain + "/" + path + "Vertex.spv";
 		shader.fragmentPath = "assets/" + domain + "/" + path + "Fragment.spv";
+		shader.vertexSourcePath = "assets/" + domain + "/" + path + "Vertex.vert";
+		shader.fragmentSourcePath = "assets/" + domain + "/" + path + "Fragment.frag";
 
 		return shader;
 	}
@@ -44,42 +167,121 @@ public:
 	std::string name = "";
 	std::string vertexPath = "";
 	std::string fragmentPath = "";
+	std::string vertexSourcePath = "";
+	std::string fragmentSourcePath = "";
+
+    ShaderVariantKey compiledFeatures = SHADER_FEATURE_NONE;
+    PipelineHandle pipeline = INVALID_PIPELINE_HANDLE;
 
 private:
 
-    std::vector<char> ReadShaderFile(const std::string& filename)
+    std::array<PipelineHandle, SHADER_VARIANT_COUNT> variants = MakeVariantTable();
+    std::array<PipelineHandle, SHADER_VARIANT_COUNT> depthVariants = MakeVariantTable();
+    std::array<ShaderCompileState, SHADER_VARIANT_COUNT> compileStates = {};
+
+    PipelineHandle RequestVariant(ShaderVariantKey key, bool depthOnly)
     {
-        std::ifstream file(filename, std::ios::ate | std::ios::binary);
+        key &= SHADER_VARIANT_COUNT - 1;
+
+        PipelineHandle& handle = depthOnly ? depthVariants[key] : variants[key];
+
+        if (handle != INVALID_PIPELINE_HANDLE)
+            return handle;
 
-        if (!file.is_open())
-            throw std::runtime_error("failed to open file: " + filename);
+#ifdef _DEBUG
+        if (IsVariantStale(key))
+        {
+            PipelineHandle fallback = RequestVariant(key & ~compiledFeatures, depthOnly);
 
-        size_t fileSize = (size_t)file.tellg();
-        std::vector<char> buffer(fileSize);
+            handle = PipelineManager::Reserve(name, fallback);
+            CompileVariantAsync(key, false);
 
-        file.seekg(0);
-        file.read(buffer.data(), fileSize);
-        file.close();
+            return handle;
+        }
+#endif
 
-        return buffer;
+        AcquireModules(key);
+
+        handle = PipelineManager::Request(GetPipelineState(key, depthOnly), name);
+
+        ReleaseModules();
+
+        return handle;
     }
 
-    VkShaderModule CreateShaderModule(const std::vector<char>& code)
+    // Tracked per output file, every key with the same compiled features shares one compile and is swapped when it lands
+    void CompileVariantAsync(ShaderVariantKey key, bool force)
     {
-        VkShaderModuleCreateInfo createInfo{};
-        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.codeSize = code.size();
-        createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+        ShaderVariantKey compiled = key & compiledFeatures;
+
+        if (compileStates[compiled] != ShaderCompileState::IDLE)
+        {
+            if (force)
+                compileStates[compiled] = ShaderCompileState::REQUEUED;
 
-        VkShaderModule shaderModule;
-        if (vkCreateShaderModule(VulkanManager::device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS)
-            Logger_ThrowError("VK_FAILURE", "Failed to create shader module!", true);
+            return;
+        }
+
+        compileStates[compiled] = ShaderCompileState::COMPILING;
+
+        Shader* shader = this;
+        std::shared_ptr<bool> succeeded = std::make_shared<bool>(false);
+
+        PipelineManager::Dispatch([shader, compiled, force, succeeded]
+        {
+            *succeeded = shader->CompileVariant(compiled, force);
+        },
+        [shader, compiled, succeeded]
+        {
+            bool requeued = shader->compileStates[compiled] == ShaderCompileState::REQUEUED;
+
+            shader->compileStates[compiled] = ShaderCompileState::IDLE;
+
+            if (requeued)
+            {
+                shader->CompileVariantAsync(compiled, true);
+                return;
+            }
+
+            if (!*succeeded)
+                return;
+
+            for (ShaderVariantKey key = 0; key < SHADER_VARIANT_COUNT; key++)
+            {
+                if ((key & shader->compiledFeatures) == compiled)
+                    shader->SwapVariant(key);
+            }
+        });
+    }
+
+    void SwapVariant(ShaderVariantKey key)
+    {
+        if (variants[key] == INVALID_PIPELINE_HANDLE && depthVariants[key] == INVALID_PIPELINE_HANDLE)
+            return;
+
+        AcquireModules(key);
+
+        if (variants[key] != INVALID_PIPELINE_HANDLE)
+            PipelineManager::Replace(variants[key], GetPipelineState(key));
+
+        if (depthVariants[key] != INVALID_PIPELINE_HANDLE)
+            PipelineManager::Replace(depthVariants[key], GetPipelineState(key, true));
+
+        ReleaseModules();
+    }
+
+    static std::array<PipelineHandle, SHADER_VARIANT_COUNT> MakeVariantTable()
+    {
+        std::array<PipelineHandle, SHADER_VARIANT_COUNT> table = {};
+        table.fill(INVALID_PIPELINE_HANDLE);
 
-        return shaderModule;
+        return table;
     }
 
-    VkShaderModule vertexShaderModule = {};
-	VkShaderModule fragmentShaderModule = {};
+    VkShaderModule vertexShaderModule = VK_NULL_HANDLE;
+	VkShaderModule fragmentShaderModule = VK_NULL_HANDLE;
+    uint64_t vertexHash = 0;
+    uint64_t fragmentHash = 0;
 };
 
 #endif // !SHADER_HPP
\ No newline at end of file
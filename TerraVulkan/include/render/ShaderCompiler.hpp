@@ -0,0 +1,95 @@
+#ifndef SHADER_COMPILER_HPP
+#define SHADER_COMPILER_HPP
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include "core/Logger.hpp"
+
+namespace ShaderCompiler
+{
+    std::string GetCompilerPath()
+    {
+        const char* sdk = std::getenv("VULKAN_SDK");
+
+#ifdef _WIN32
+        if (sdk != nullptr)
+            return (std::filesystem::path(sdk) / "Bin" / "glslangValidator.exe").string();
+#else
+        if (sdk != nullptr)
+            return (std::filesystem::path(sdk) / "bin" / "glslangValidator").string();
+#endif
+
+        return "glslangValidator";
+    }
+
+    std::string GetOutputPath(const std::string& source)
+    {
+        return std::filesystem::path(source).replace_extension(".spv").lexically_normal().generic_string();
+    }
+
+    bool IsSource(const std::string& path)
+    {
+        std::string extension = std::filesystem::path(path).extension().string();
+
+        return extension == ".vert" || extension == ".frag";
+    }
+
+    bool Compile(const std::string& source, const std::string& output, const std::vector<std::string>& defines = {})
+    {
+        std::string logPath = output + ".log";
+        std::string command = "\"" + GetCompilerPath() + "\" -V";
+
+        for (const auto& define : defines)
+            command += " -D" + define;
+
+        command += " \"" + source + "\" -o \"" + output + "\" > \"" + logPath + "\" 2>&1";
+
+#ifdef _WIN32
+        command = "\"" + command + "\"";
+#endif
+
+        int result = std::system(command.c_str());
+
+        std::ifstream log(logPath);
+        std::stringstream messages;
+        messages << log.rdbuf();
+        log.close();
+
+        std::error_code error;
+        std::filesystem::remove(logPath, error);
+
+        if (result != 0)
+        {
+            Logger_ThrowError("GLSL", "Failed to compile '" + source + "':\n" + messages.str(), false);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool IsStale(const std::string& source, const std::string& output)
+    {
+        std::error_code error;
+
+        if (!std::filesystem::exists(source, error))
+            return false;
+
+        return !std::filesystem::exists(output, error) || std::filesystem::last_write_time(output, error) < std::filesystem::last_write_time(source, error);
+    }
+
+    bool CompileIfStale(const std::string& source, const std::string& output, const std::vector<std::string>& defines = {})
+    {
+        if (!IsStale(source, output))
+            return true;
+
+        Logger_WriteConsole("Compiling out of date shader '" + source + "'", LogLevel::DEBUG);
+
+        return Compile(source, output, defines);
+    }
+}
+
+#endif // !SHADER_COMPILER_HPP
@@ -0,0 +1,49 @@
+#ifndef SHADER_FEATURE_HPP
+#define SHADER_FEATURE_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "core/PipelineManager.hpp"
+
+#define SHADER_FEATURE_COUNT 4
+#define SHADER_VARIANT_COUNT (1u << SHADER_FEATURE_COUNT)
+
+typedef uint32_t ShaderVariantKey;
+
+// One bit per feature, a bool specialization constant with constant_id equal to its bit unless compiled in (see Shader::Register)
+enum ShaderFeature : ShaderVariantKey
+{
+    SHADER_FEATURE_NONE = 0,
+    SHADER_FEATURE_ALPHA_TEST = 1u << 0,
+    SHADER_FEATURE_FOG = 1u << 1,
+    SHADER_FEATURE_AMBIENT_OCCLUSION = 1u << 2,
+    SHADER_FEATURE_VERTEX_COLOR = 1u << 3
+};
+
+static_assert(SHADER_FEATURE_COUNT <= MAX_SPECIALIZATION_CONSTANTS, "Every shader feature needs a specialization constant slot");
+
+namespace ShaderFeatures
+{
+    const char* GetName(uint32_t bit)
+    {
+        static const char* names[SHADER_FEATURE_COUNT] = { "ALPHA_TEST", "FOG", "AMBIENT_OCCLUSION", "VERTEX_COLOR" };
+
+        return bit < SHADER_FEATURE_COUNT ? names[bit] : "";
+    }
+
+    std::vector<std::string> GetDefines(ShaderVariantKey key)
+    {
+        std::vector<std::string> defines;
+
+        for (uint32_t bit = 0; bit < SHADER_FEATURE_COUNT; bit++)
+        {
+            if (key & (1u << bit))
+                defines.push_back(GetName(bit));
+        }
+
+        return defines;
+    }
+}
+
+#endif // !SHADER_FEATURE_HPP
@@ -0,0 +1,87 @@
+#ifndef SHADER_HOT_RELOAD_HPP
+#define SHADER_HOT_RELOAD_HPP
+
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include "core/LoopController.hpp"
+#include "core/Settings.hpp"
+#include "render/ShaderManager.hpp"
+#include "render/ShaderCompiler.hpp"
+#include "thread/ThreadTaskExecutor.hpp"
+#include "util/FileWatcher.hpp"
+
+struct CompiledShader
+{
+    std::string path = "";
+    std::chrono::steady_clock::time_point detected = {};
+};
+
+namespace ShaderHotReload
+{
+    std::unique_ptr<ThreadTaskExecutor> compiler;
+    std::unique_ptr<FileWatcher> watcher;
+    std::vector<CompiledShader> compiled;
+    std::mutex mutex;
+
+    void Initialize(const std::string& directory = "assets/" + Settings::domain + "/shaders")
+    {
+        compiler = std::make_unique<ThreadTaskExecutor>();
+
+        watcher = std::make_unique<FileWatcher>(directory, [](const std::string& path)
+        {
+            if (!ShaderCompiler::IsSource(path))
+                return;
+
+            auto detected = std::chrono::steady_clock::now();
+
+            compiler->AddTask([path, detected]
+            {
+                std::string output = ShaderCompiler::GetOutputPath(path);
+
+                if (!ShaderCompiler::Compile(path, output))
+                    return;
+
+                std::lock_guard<std::mutex> lock(mutex);
+                compiled.push_back({ output, detected });
+            });
+        });
+
+        Logger_WriteConsole("Watching '" + directory + "' for shader changes", LogLevel::DEBUG);
+    }
+
+    void Update()
+    {
+        std::vector<CompiledShader> ready;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready.swap(compiled);
+        }
+
+        for (const CompiledShader& shaderFile : ready)
+        {
+            for (auto& [name, shader] : ShaderManager::shaders)
+            {
+                if (ShaderCompiler::GetOutputPath(shader.vertexPath) != shaderFile.path && ShaderCompiler::GetOutputPath(shader.fragmentPath) != shaderFile.path)
+                    continue;
+
+                shader.Reload();
+                LoopController::RequestRedraw();
+
+                double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - shaderFile.detected).count();
+
+                Logger_WriteConsole(std::format("Reloaded shader '{}' ({:.1f} ms after the change)", name, milliseconds), LogLevel::INFO);
+            }
+        }
+    }
+
+    void CleanUp()
+    {
+        watcher.reset();
+        compiler.reset();
+    }
+}
+
+#endif // !SHADER_HOT_RELOAD_HPP
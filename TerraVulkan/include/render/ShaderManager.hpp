@@ -2,7 +2,9 @@
 #define SHADER_MANAGER_HPP
 
 #include <unordered_map>
+#include "core/AllocationTracker.hpp"
 #include "render/Shader.hpp"
+#include "render/ShaderCompiler.hpp"
 
 namespace ShaderManager
 {
@@ -13,10 +15,47 @@ namespace ShaderManager
 		shaders.insert({ shader.name, shader });
 	}
 
+	static void WarmUp()
+	{
+		for (const auto& entry : PipelineManager::LoadWarmUpList())
+		{
+			auto found = shaders.find(entry.name);
+
+			if (found == shaders.end())
+				continue;
+
+			ShaderVariantKey key = entry.state.specialization;
+
+#ifdef _DEBUG
+			found->second.CompileVariant(key, false);
+#endif
+			found->second.AcquireModules(key);
+
+			PipelineState state = found->second.GetPipelineState(key);
+			state.CopyFixedFunction(entry.state);
+
+			PipelineManager::Request(state, entry.name);
+
+			found->second.ReleaseModules();
+		}
+	}
+
 	static void Generate()
 	{
+		TERRA_ALLOCATION_SCOPE(AllocationTag::SHADER);
+
+#ifdef _DEBUG
+		for (auto& [name, shader] : shaders)
+		{
+			ShaderCompiler::CompileIfStale(shader.vertexSourcePath, shader.vertexPath);
+			ShaderCompiler::CompileIfStale(shader.fragmentSourcePath, shader.fragmentPath);
+		}
+#endif
+
 		for(auto& [name, shader] : shaders)
 			shader.Generate();
+
+		WarmUp();
 	}
 
 	static Shader& Get(const std::string& name)
@@ -24,8 +63,20 @@ namespace ShaderManager
 		return shaders[name];
 	}
 
+	static PipelineHandle GetVariant(const std::string& name, ShaderVariantKey key)
+	{
+		return shaders[name].GetVariant(key);
+	}
+
+	static PipelineHandle GetDepthVariant(const std::string& name, ShaderVariantKey key)
+	{
+		return shaders[name].GetDepthVariant(key);
+	}
+
 	static void CleanUp()
 	{
+		PipelineManager::WaitIdle();
+
 		for (auto& [name, shader] : shaders)
 			shader.CleanUp();
 	}
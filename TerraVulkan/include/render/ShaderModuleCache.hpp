@@ -0,0 +1,164 @@
+#ifndef SHADER_MODULE_CACHE_HPP
+#define SHADER_MODULE_CACHE_HPP
+
+#include <string>
+#include <mutex>
+#include <unordered_map>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core/AllocationTracker.hpp"
+#include "core/Logger.hpp"
+#include "render/ShaderReflection.hpp"
+#include "util/Hash.hpp"
+#include "util/MappedFile.hpp"
+
+#define SPIRV_MAGIC_NUMBER 0x07230203u
+
+struct CachedShaderModule
+{
+    VkShaderModule module = VK_NULL_HANDLE;
+    uint64_t hash = 0;
+};
+
+struct ShaderModuleEntry
+{
+    VkShaderModule module = VK_NULL_HANDLE;
+    uint32_t references = 0;
+    std::string path = "";
+
+    ShaderReflection reflection = {};
+};
+
+namespace ShaderModuleCache
+{
+    std::unordered_map<uint64_t, ShaderModuleEntry> modules;
+    std::recursive_mutex mutex;
+    VkDevice device;
+
+    void Initialize(VkDevice device)
+    {
+        ShaderModuleCache::device = device;
+    }
+
+    CachedShaderModule Acquire(const std::string& path)
+    {
+        MappedFile file;
+
+        if (!file.Open(path))
+        {
+            Logger_ThrowError("IO_FAILURE", "Failed to map shader file: " + path, true);
+            return {};
+        }
+
+        const uint32_t* code = static_cast<const uint32_t*>(file.Data());
+
+        if (file.Size() % sizeof(uint32_t) != 0 || code[0] != SPIRV_MAGIC_NUMBER)
+        {
+            Logger_ThrowError("SPIR-V", "'" + path + "' is not a valid SPIR-V module", true);
+            return {};
+        }
+
+        uint64_t hash = Hash::Combine(Hash::FNV1a(file.Data(), file.Size()), file.Size());
+
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+
+        ShaderModuleEntry& entry = modules[hash];
+
+        entry.path = path;
+
+        if (!entry.reflection.valid)
+        {
+            entry.reflection = ShaderReflector::Reflect(code, file.Size() / sizeof(uint32_t));
+
+            if (!entry.reflection.valid)
+                Logger_ThrowError("SPIR-V", "Failed to reflect '" + path + "'", false);
+        }
+
+        if (entry.module == VK_NULL_HANDLE)
+        {
+            VkShaderModuleCreateInfo createInfo{};
+            createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+            createInfo.codeSize = file.Size();
+            createInfo.pCode = code;
+
+            if (vkCreateShaderModule(device, &createInfo, VULKAN_ALLOCATOR, &entry.module) != VK_SUCCESS)
+                Logger_ThrowError("VK_FAILURE", "Failed to create shader module!", true);
+        }
+
+        entry.references++;
+
+        return { entry.module, hash };
+    }
+
+    VkShaderModule AcquireByHash(uint64_t hash)
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+
+        auto found = modules.find(hash);
+
+        if (found == modules.end())
+            return VK_NULL_HANDLE;
+
+        if (found->second.module != VK_NULL_HANDLE)
+        {
+            found->second.references++;
+            return found->second.module;
+        }
+
+        std::string path = found->second.path;
+        CachedShaderModule reloaded = Acquire(path);
+
+        if (reloaded.hash == hash)
+            return reloaded.module;
+
+        Release(reloaded.hash);
+
+        Logger_WriteConsole("Shader '" + path + "' changed on disk since its pipelines were built", LogLevel::WARNING);
+
+        return VK_NULL_HANDLE;
+    }
+
+    const ShaderReflection& GetReflection(uint64_t hash)
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+
+        return modules[hash].reflection;
+    }
+
+    void Retain(uint64_t hash)
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+
+        modules[hash].references++;
+    }
+
+    void Release(uint64_t hash)
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+
+        auto found = modules.find(hash);
+
+        if (found == modules.end() || found->second.references == 0)
+            return;
+
+        if (--found->second.references == 0)
+        {
+            vkDestroyShaderModule(device, found->second.module, VULKAN_ALLOCATOR);
+            found->second.module = VK_NULL_HANDLE;
+        }
+    }
+
+    void CleanUp()
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+
+        for (auto& [hash, entry] : modules)
+            vkDestroyShaderModule(device, entry.module, VULKAN_ALLOCATOR);
+
+        modules.clear();
+    }
+}
+
+#endif // !SHADER_MODULE_CACHE_HPP
@@ -0,0 +1,413 @@
+#ifndef SHADER_REFLECTION_HPP
+#define SHADER_REFLECTION_HPP
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#define SPIRV_HEADER_WORDS 5
+
+enum class SpirvOp : uint16_t
+{
+    ENTRY_POINT = 15,
+    TYPE_BOOL = 20,
+    TYPE_INT = 21,
+    TYPE_FLOAT = 22,
+    TYPE_VECTOR = 23,
+    TYPE_MATRIX = 24,
+    TYPE_IMAGE = 25,
+    TYPE_SAMPLER = 26,
+    TYPE_SAMPLED_IMAGE = 27,
+    TYPE_ARRAY = 28,
+    TYPE_RUNTIME_ARRAY = 29,
+    TYPE_STRUCT = 30,
+    TYPE_POINTER = 32,
+    CONSTANT = 43,
+    VARIABLE = 59,
+    DECORATE = 71,
+    MEMBER_DECORATE = 72
+};
+
+enum class SpirvStorage : uint32_t
+{
+    UNIFORM_CONSTANT = 0,
+    INPUT = 1,
+    UNIFORM = 2,
+    PUSH_CONSTANT = 9,
+    STORAGE_BUFFER = 12
+};
+
+enum class SpirvDecoration : uint32_t
+{
+    BLOCK = 2,
+    BUFFER_BLOCK = 3,
+    ARRAY_STRIDE = 6,
+    MATRIX_STRIDE = 7,
+    BUILT_IN = 11,
+    LOCATION = 30,
+    BINDING = 33,
+    DESCRIPTOR_SET = 34,
+    OFFSET = 35
+};
+
+struct ShaderInput
+{
+    uint32_t location = 0;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+};
+
+struct ShaderBinding
+{
+    uint32_t set = 0;
+    uint32_t binding = 0;
+    VkDescriptorType type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+    uint32_t count = 1;
+};
+
+struct ShaderReflection
+{
+    VkShaderStageFlagBits stage = VK_SHADER_STAGE_ALL;
+
+    std::vector<ShaderInput> inputs = {};
+    std::vector<ShaderBinding> bindings = {};
+    uint32_t pushConstantSize = 0;
+
+    bool valid = false;
+};
+
+namespace ShaderReflector
+{
+    struct SpirvId
+    {
+        SpirvOp op = (SpirvOp)0;
+        std::vector<uint32_t> operands = {};
+
+        uint32_t location = UINT32_MAX;
+        uint32_t binding = UINT32_MAX;
+        uint32_t set = UINT32_MAX;
+        uint32_t arrayStride = 0;
+        uint32_t matrixStride = 0;
+        bool builtIn = false;
+        bool block = false;
+        bool bufferBlock = false;
+
+        std::vector<uint32_t> memberOffsets = {};
+        std::vector<uint32_t> memberMatrixStrides = {};
+    };
+
+    VkShaderStageFlagBits GetStage(uint32_t executionModel)
+    {
+        switch (executionModel)
+        {
+        case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+        case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+        case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+        case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+        case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+        case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+        default: return VK_SHADER_STAGE_ALL;
+        }
+    }
+
+    VkFormat GetInputFormat(const std::unordered_map<uint32_t, SpirvId>& ids, uint32_t typeId)
+    {
+        auto found = ids.find(typeId);
+
+        if (found == ids.end())
+            return VK_FORMAT_UNDEFINED;
+
+        const SpirvId& type = found->second;
+        uint32_t components = 1;
+        const SpirvId* scalar = &type;
+
+        if (type.op == SpirvOp::TYPE_VECTOR)
+        {
+            components = type.operands[1];
+            scalar = &ids.at(type.operands[0]);
+        }
+
+        static const VkFormat floatFormats[] = { VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT };
+        static const VkFormat intFormats[] = { VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT };
+        static const VkFormat uintFormats[] = { VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT };
+
+        if (components < 1 || components > 4)
+            return VK_FORMAT_UNDEFINED;
+
+        if (scalar->op == SpirvOp::TYPE_FLOAT)
+            return floatFormats[components - 1];
+
+        if (scalar->op == SpirvOp::TYPE_INT)
+            return scalar->operands[1] != 0 ? intFormats[components - 1] : uintFormats[components - 1];
+
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    uint32_t GetTypeSize(const std::unordered_map<uint32_t, SpirvId>& ids, uint32_t typeId, uint32_t matrixStride = 0)
+    {
+        auto found = ids.find(typeId);
+
+        if (found == ids.end())
+            return 0;
+
+        const SpirvId& type = found->second;
+
+        switch (type.op)
+        {
+        case SpirvOp::TYPE_BOOL:
+            return 4;
+
+        case SpirvOp::TYPE_INT:
+        case SpirvOp::TYPE_FLOAT:
+            return type.operands[0] / 8;
+
+        case SpirvOp::TYPE_VECTOR:
+            return GetTypeSize(ids, type.operands[0]) * type.operands[1];
+
+        case SpirvOp::TYPE_MATRIX:
+            return (matrixStride != 0 ? matrixStride : GetTypeSize(ids, type.operands[0])) * type.operands[1];
+
+        case SpirvOp::TYPE_ARRAY:
+        {
+            auto length = ids.find(type.operands[1]);
+            uint32_t count = length != ids.end() && length->second.op == SpirvOp::CONSTANT ? length->second.operands[1] : 1;
+
+            return (type.arrayStride != 0 ? type.arrayStride : GetTypeSize(ids, type.operands[0])) * count;
+        }
+
+        case SpirvOp::TYPE_STRUCT:
+        {
+            uint32_t size = 0;
+
+            for (size_t member = 0; member < type.operands.size(); member++)
+            {
+                uint32_t offset = member < type.memberOffsets.size() ? type.memberOffsets[member] : size;
+                uint32_t stride = member < type.memberMatrixStrides.size() ? type.memberMatrixStrides[member] : 0;
+
+                size = std::max(size, offset + GetTypeSize(ids, type.operands[member], stride));
+            }
+
+            return size;
+        }
+
+        default:
+            return 0;
+        }
+    }
+
+    bool GetDescriptor(const std::unordered_map<uint32_t, SpirvId>& ids, SpirvStorage storage, uint32_t typeId, ShaderBinding& binding)
+    {
+        const SpirvId* type = &ids.at(typeId);
+
+        binding.count = 1;
+
+        while (type->op == SpirvOp::TYPE_ARRAY || type->op == SpirvOp::TYPE_RUNTIME_ARRAY)
+        {
+            if (type->op == SpirvOp::TYPE_ARRAY)
+            {
+                auto length = ids.find(type->operands[1]);
+                binding.count *= length != ids.end() && length->second.op == SpirvOp::CONSTANT ? length->second.operands[1] : 1;
+            }
+            else
+                binding.count = 0;
+
+            type = &ids.at(type->operands[0]);
+        }
+
+        switch (storage)
+        {
+        case SpirvStorage::UNIFORM_CONSTANT:
+            if (type->op == SpirvOp::TYPE_SAMPLED_IMAGE)
+                binding.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            else if (type->op == SpirvOp::TYPE_SAMPLER)
+                binding.type = VK_DESCRIPTOR_TYPE_SAMPLER;
+            else if (type->op == SpirvOp::TYPE_IMAGE)
+            {
+                bool buffer = type->operands[1] == 5;
+                bool storageImage = type->operands[5] == 2;
+
+                if (buffer)
+                    binding.type = storageImage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                else
+                    binding.type = storageImage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            }
+            else
+                return false;
+
+            return true;
+
+        case SpirvStorage::UNIFORM:
+            binding.type = type->bufferBlock ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            return true;
+
+        case SpirvStorage::STORAGE_BUFFER:
+            binding.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    ShaderReflection Reflect(const uint32_t* code, size_t wordCount)
+    {
+        ShaderReflection reflection = {};
+
+        if (wordCount < SPIRV_HEADER_WORDS || code[0] != 0x07230203u)
+            return reflection;
+
+        std::unordered_map<uint32_t, SpirvId> ids;
+        std::vector<uint32_t> variables;
+
+        for (size_t position = SPIRV_HEADER_WORDS; position < wordCount;)
+        {
+            uint32_t instruction = code[position];
+            uint32_t length = instruction >> 16;
+            SpirvOp op = (SpirvOp)(instruction & 0xFFFF);
+
+            if (length == 0 || position + length > wordCount)
+                return reflection;
+
+            const uint32_t* operands = code + position + 1;
+            uint32_t operandCount = length - 1;
+
+            switch (op)
+            {
+            case SpirvOp::ENTRY_POINT:
+                if (reflection.stage == VK_SHADER_STAGE_ALL)
+                    reflection.stage = GetStage(operands[0]);
+                break;
+
+            case SpirvOp::DECORATE:
+            {
+                SpirvId& target = ids[operands[0]];
+                SpirvDecoration decoration = (SpirvDecoration)operands[1];
+                uint32_t literal = operandCount > 2 ? operands[2] : 0;
+
+                switch (decoration)
+                {
+                case SpirvDecoration::BLOCK: target.block = true; break;
+                case SpirvDecoration::BUFFER_BLOCK: target.bufferBlock = true; break;
+                case SpirvDecoration::ARRAY_STRIDE: target.arrayStride = literal; break;
+                case SpirvDecoration::BUILT_IN: target.builtIn = true; break;
+                case SpirvDecoration::LOCATION: target.location = literal; break;
+                case SpirvDecoration::BINDING: target.binding = literal; break;
+                case SpirvDecoration::DESCRIPTOR_SET: target.set = literal; break;
+                default: break;
+                }
+
+                break;
+            }
+
+            case SpirvOp::MEMBER_DECORATE:
+            {
+                SpirvId& target = ids[operands[0]];
+                uint32_t member = operands[1];
+                SpirvDecoration decoration = (SpirvDecoration)operands[2];
+                uint32_t literal = operandCount > 3 ? operands[3] : 0;
+
+                if (decoration == SpirvDecoration::OFFSET)
+                {
+                    target.memberOffsets.resize(std::max<size_t>(target.memberOffsets.size(), member + 1), 0);
+                    target.memberOffsets[member] = literal;
+                }
+                else if (decoration == SpirvDecoration::MATRIX_STRIDE)
+                {
+                    target.memberMatrixStrides.resize(std::max<size_t>(target.memberMatrixStrides.size(), member + 1), 0);
+                    target.memberMatrixStrides[member] = literal;
+                }
+                else if (decoration == SpirvDecoration::BUILT_IN)
+                    target.builtIn = true;
+
+                break;
+            }
+
+            case SpirvOp::TYPE_BOOL:
+            case SpirvOp::TYPE_INT:
+            case SpirvOp::TYPE_FLOAT:
+            case SpirvOp::TYPE_VECTOR:
+            case SpirvOp::TYPE_MATRIX:
+            case SpirvOp::TYPE_IMAGE:
+            case SpirvOp::TYPE_SAMPLER:
+            case SpirvOp::TYPE_SAMPLED_IMAGE:
+            case SpirvOp::TYPE_ARRAY:
+            case SpirvOp::TYPE_RUNTIME_ARRAY:
+            case SpirvOp::TYPE_STRUCT:
+            case SpirvOp::TYPE_POINTER:
+            {
+                SpirvId& target = ids[operands[0]];
+
+                target.op = op;
+                target.operands.assign(operands + 1, operands + operandCount);
+
+                break;
+            }
+
+            case SpirvOp::CONSTANT:
+            case SpirvOp::VARIABLE:
+            {
+                SpirvId& target = ids[operands[1]];
+
+                target.op = op;
+                target.operands.assign(operands, operands + operandCount);
+                target.operands.erase(target.operands.begin() + 1);
+
+                if (op == SpirvOp::VARIABLE)
+                    variables.push_back(operands[1]);
+
+                break;
+            }
+
+            default:
+                break;
+            }
+
+            position += length;
+        }
+
+        for (uint32_t id : variables)
+        {
+            const SpirvId& variable = ids[id];
+            const SpirvId& pointer = ids[variable.operands[0]];
+
+            if (pointer.op != SpirvOp::TYPE_POINTER)
+                continue;
+
+            SpirvStorage storage = (SpirvStorage)variable.operands[1];
+            uint32_t typeId = pointer.operands[1];
+
+            if (storage == SpirvStorage::INPUT)
+            {
+                if (variable.builtIn || ids[typeId].builtIn || variable.location == UINT32_MAX)
+                    continue;
+
+                reflection.inputs.push_back({ variable.location, GetInputFormat(ids, typeId) });
+            }
+            else if (storage == SpirvStorage::PUSH_CONSTANT)
+                reflection.pushConstantSize = std::max(reflection.pushConstantSize, GetTypeSize(ids, typeId));
+            else if (variable.binding != UINT32_MAX)
+            {
+                ShaderBinding binding = {};
+
+                binding.set = variable.set == UINT32_MAX ? 0 : variable.set;
+                binding.binding = variable.binding;
+
+                if (GetDescriptor(ids, storage, typeId, binding))
+                    reflection.bindings.push_back(binding);
+            }
+        }
+
+        std::sort(reflection.inputs.begin(), reflection.inputs.end(), [](const ShaderInput& a, const ShaderInput& b) { return a.location < b.location; });
+        std::sort(reflection.bindings.begin(), reflection.bindings.end(), [](const ShaderBinding& a, const ShaderBinding& b) { return a.set != b.set ? a.set < b.set : a.binding < b.binding; });
+
+        reflection.valid = true;
+
+        return reflection;
+    }
+}
+
+#endif // !SHADER_REFLECTION_HPP
@@ -0,0 +1,262 @@
+#ifndef TEXTURE_REGISTRY_HPP
+#define TEXTURE_REGISTRY_HPP
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include "core/AllocationTracker.hpp"
+#include "core/Settings.hpp"
+#include "core/VulkanManager.hpp"
+#include "core/ImageCache.hpp"
+#include "util/BlockCompression.hpp"
+#include "util/ImageHelper.hpp"
+#include "util/ImageLoader.hpp"
+#include "util/MeshHelper.hpp"
+#include "util/TextureProcessor.hpp"
+
+#define MISSING_TEXTURE_LAYER 0
+#define MISSING_TEXTURE_SIZE 16
+
+struct BlockTexture
+{
+    std::string name = "";
+    std::string path = "";
+
+    ProcessedTexture data = {};
+};
+
+namespace TextureRegistry
+{
+    std::vector<BlockTexture> textures;
+    std::unordered_map<std::string, uint32_t> layers;
+
+    TextureCompression preferredCompression = TextureCompression::BC7;
+    MipFilter mipFilter = MipFilter::KAISER;
+
+    TextureCompression compression = TextureCompression::NONE;
+    VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory imageMemory = VK_NULL_HANDLE;
+    VkImageView imageView = VK_NULL_HANDLE;
+    uint32_t mipLevels = 1;
+
+    uint32_t Register(const std::string& name, const std::string& path, const std::string& domain = Settings::domain)
+    {
+        if (textures.empty())
+            textures.push_back({ "missing", "" });
+
+        auto found = layers.find(name);
+
+        if (found != layers.end())
+            return found->second;
+
+        uint32_t layer = static_cast<uint32_t>(textures.size());
+
+        textures.push_back({ name, "assets/" + domain + "/" + path });
+        layers.insert({ name, layer });
+
+        return layer;
+    }
+
+    uint32_t GetLayer(const std::string& name)
+    {
+        auto found = layers.find(name);
+
+        return found != layers.end() ? found->second : MISSING_TEXTURE_LAYER;
+    }
+
+    ImageData GenerateMissing(uint32_t width, uint32_t height)
+    {
+        ImageData missing = {};
+
+        missing.width = width;
+        missing.height = height;
+        missing.pixels.resize((size_t)width * height * 4);
+
+        for (uint32_t y = 0; y < height; y++)
+        {
+            for (uint32_t x = 0; x < width; x++)
+            {
+                bool checker = ((x * 2 / width) + (y * 2 / height)) % 2 == 0;
+                uint8_t* pixel = &missing.pixels[((size_t)y * width + x) * 4];
+
+                pixel[0] = checker ? 255 : 0;
+                pixel[1] = 0;
+                pixel[2] = checker ? 255 : 0;
+                pixel[3] = 255;
+            }
+        }
+
+        return missing;
+    }
+
+    VkFormat GetFormat(TextureCompression compression)
+    {
+        switch (compression)
+        {
+        case TextureCompression::BC1:
+            return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+        case TextureCompression::BC7:
+            return VK_FORMAT_BC7_SRGB_BLOCK;
+        default:
+            return VK_FORMAT_R8G8B8A8_SRGB;
+        }
+    }
+
+    TextureCompression SelectCompression(TextureCompression preferred)
+    {
+        if (preferred == TextureCompression::NONE || !VulkanManager::enabledFeatures.textureCompressionBC)
+            return TextureCompression::NONE;
+
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(VulkanManager::physicalDevice, GetFormat(preferred), &formatProperties);
+
+        if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT))
+            return TextureCompression::NONE;
+
+        return preferred;
+    }
+
+    void Upload(uint32_t width, uint32_t height)
+    {
+        uint32_t layerCount = static_cast<uint32_t>(textures.size());
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(VulkanManager::physicalDevice, &properties);
+
+        if (layerCount > properties.limits.maxImageArrayLayers)
+            Logger_ThrowError("VK_FAILURE", std::format("{} block textures exceed the device limit of {} array layers", layerCount, properties.limits.maxImageArrayLayers), true);
+
+        mipLevels = static_cast<uint32_t>(textures[MISSING_TEXTURE_LAYER].data.levels.size());
+
+        std::vector<VkBufferImageCopy> regions(mipLevels);
+        VkDeviceSize bufferSize = 0;
+
+        for (uint32_t level = 0; level < mipLevels; level++)
+        {
+            uint32_t levelWidth = std::max(width >> level, 1u);
+            uint32_t levelHeight = std::max(height >> level, 1u);
+
+            regions[level].bufferOffset = bufferSize;
+            regions[level].imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, layerCount };
+            regions[level].imageExtent = { levelWidth, levelHeight, 1 };
+
+            bufferSize += BlockCompression::GetLevelSize(compression, levelWidth, levelHeight) * layerCount;
+        }
+
+        VkBuffer stagingBuffer;
+        VkDeviceMemory stagingBufferMemory;
+        MeshHelper::GenerateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+
+        void* data;
+        vkMapMemory(VulkanManager::device, stagingBufferMemory, 0, bufferSize, 0, &data);
+
+        for (uint32_t level = 0; level < mipLevels; level++)
+        {
+            char* destination = static_cast<char*>(data) + regions[level].bufferOffset;
+
+            for (uint32_t layer = 0; layer < layerCount; layer++)
+            {
+                const std::vector<uint8_t>& source = textures[layer].data.levels[level];
+
+                memcpy(destination + layer * source.size(), source.data(), source.size());
+            }
+        }
+
+        vkUnmapMemory(VulkanManager::device, stagingBufferMemory);
+
+        ImageHelper::GenerateImage(width, height, mipLevels, layerCount, format, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, imageMemory);
+
+        VkCommandBuffer commandBuffer = ImageHelper::BeginSingleTimeCommands();
+
+        ImageHelper::TransitionImageLayout(commandBuffer, image, VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, layerCount, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+        vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+
+        ImageHelper::TransitionImageLayout(commandBuffer, image, VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, layerCount, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+        ImageHelper::EndSingleTimeCommands(commandBuffer);
+
+        vkDestroyBuffer(VulkanManager::device, stagingBuffer, VULKAN_ALLOCATOR);
+        vkFreeMemory(VulkanManager::device, stagingBufferMemory, VULKAN_ALLOCATOR);
+
+        imageView = ImageCache::AcquireImageView(ImageHelper::GetImageViewInformation(image, VK_IMAGE_VIEW_TYPE_2D_ARRAY, format, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, layerCount));
+    }
+
+    void Generate()
+    {
+        TERRA_ALLOCATION_SCOPE(AllocationTag::TEXTURE);
+
+        if (textures.empty())
+            textures.push_back({ "missing", "" });
+
+        compression = SelectCompression(preferredCompression);
+        format = GetFormat(compression);
+
+        std::vector<std::string> paths;
+
+        for (size_t layer = 1; layer < textures.size(); layer++)
+            paths.push_back(textures[layer].path);
+
+        std::vector<ProcessedTexture> processed = TextureProcessor::ProcessFiles(paths, compression, mipFilter);
+
+        for (size_t layer = 1; layer < textures.size(); layer++)
+            textures[layer].data = std::move(processed[layer - 1]);
+
+        uint32_t width = MISSING_TEXTURE_SIZE;
+        uint32_t height = MISSING_TEXTURE_SIZE;
+
+        auto first = std::find_if(textures.begin() + 1, textures.end(), [](const BlockTexture& texture) { return texture.data.Valid(); });
+
+        if (first != textures.end())
+        {
+            width = first->data.width;
+            height = first->data.height;
+        }
+
+        ProcessedTexture missing = TextureProcessor::ProcessImage(GenerateMissing(width, height), compression, mipFilter);
+
+        for (size_t layer = 1; layer < textures.size(); layer++)
+        {
+            BlockTexture& texture = textures[layer];
+
+            if (!texture.data.Valid())
+                Logger_WriteConsole("Failed to load block texture '" + texture.path + "'", LogLevel::WARNING);
+            else if (texture.data.width != width || texture.data.height != height)
+                Logger_WriteConsole(std::format("Block texture '{}' is {}x{}, expected {}x{}", texture.path, texture.data.width, texture.data.height, width, height), LogLevel::WARNING);
+            else
+                continue;
+
+            texture.data = missing;
+        }
+
+        textures[MISSING_TEXTURE_LAYER].data = std::move(missing);
+
+        Upload(width, height);
+
+        for (auto& texture : textures)
+            texture.data = {};
+
+        Logger_WriteConsole(std::format("Packed {} block textures into a {}x{} {} array with {} mip levels", textures.size() - 1, width, height, BlockCompression::GetName(compression), mipLevels), LogLevel::INFO);
+    }
+
+    void CleanUp()
+    {
+        vkDeviceWaitIdle(VulkanManager::device);
+
+        ImageCache::ReleaseImageView(imageView);
+        ImageCache::DestroyImageViews(image);
+
+        vkDestroyImage(VulkanManager::device, image, VULKAN_ALLOCATOR);
+        vkFreeMemory(VulkanManager::device, imageMemory, VULKAN_ALLOCATOR);
+
+        imageView = VK_NULL_HANDLE;
+        image = VK_NULL_HANDLE;
+        imageMemory = VK_NULL_HANDLE;
+    }
+}
+
+#endif // !TEXTURE_REGISTRY_HPP
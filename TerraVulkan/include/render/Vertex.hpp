@@ -15,6 +15,7 @@ struct Vertex
 	glm::vec3 position;
 	glm::vec3 color;
 	glm::vec2 textureCoordinates;
+	uint32_t textureLayer;
 
 	static VkVertexInputBindingDescription GetBindingDescription()
 	{
@@ -31,7 +32,7 @@ struct Vertex
 	{
 		std::vector<VkVertexInputAttributeDescription> attributeDescriptions = {};
 
-		attributeDescriptions.resize(3);
+		attributeDescriptions.resize(4);
 
 		attributeDescriptions[0].binding = 0;
 		attributeDescriptions[0].location = 0;
@@ -48,6 +49,11 @@ struct Vertex
 		attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
 		attributeDescriptions[2].offset = GetMember(Vertex, textureCoordinates);
 
+		attributeDescriptions[3].binding = 0;
+		attributeDescriptions[3].location = 3;
+		attributeDescriptions[3].format = VK_FORMAT_R32_UINT;
+		attributeDescriptions[3].offset = GetMember(Vertex, textureLayer);
+
 		return attributeDescriptions;
 	}
 
@@ -72,6 +78,15 @@ struct Vertex
 
 		return vertex;
 	}
+
+	static Vertex Register(const glm::vec3& position, const glm::vec3& color, const glm::vec2& textureCoordinates, uint32_t textureLayer)
+	{
+		Vertex vertex = Register(position, color, textureCoordinates);
+
+		vertex.textureLayer = textureLayer;
+
+		return vertex;
+	}
 };
 
 #endif // !VERTEX_HPP
\ No newline at end of file
@@ -0,0 +1,168 @@
+#ifndef FIXED_TIMESTEP_SIMULATION_HPP
+#define FIXED_TIMESTEP_SIMULATION_HPP
+
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <format>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+#include "core/Logger.hpp"
+#include "core/Profiler.hpp"
+#include "thread/TripleBuffer.hpp"
+
+#define SIMULATION_DEFAULT_TICK_RATE 60.0
+#define SIMULATION_MAX_CATCH_UP 5
+
+template<typename State>
+struct SimulationSnapshot
+{
+    State previous = {};
+    State current = {};
+
+    uint64_t tick = 0;
+    std::chrono::steady_clock::time_point time = {};
+};
+
+// State needs a static Interpolate(previous, current, alpha), rendering runs one tick behind and blends the last two states
+template<typename State>
+class FixedTimestepSimulation
+{
+
+public:
+
+    using TickFunction = std::function<void(State&, double)>;
+
+    FixedTimestepSimulation(TickFunction tick, const State& initial = {}, double tickRate = SIMULATION_DEFAULT_TICK_RATE) : tick(std::move(tick)), state(initial), snapshots({ initial, initial, 0, std::chrono::steady_clock::now() })
+    {
+        step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / std::max(tickRate, 1.0)));
+    }
+
+    ~FixedTimestepSimulation()
+    {
+        Stop();
+    }
+
+    void Start()
+    {
+        if (worker.joinable())
+            return;
+
+        stop = false;
+        worker = std::thread([this] { Run(); });
+    }
+
+    void Stop()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            stop = true;
+        }
+
+        cv.notify_all();
+
+        if (worker.joinable())
+            worker.join();
+    }
+
+    State Sample()
+    {
+        snapshots.Update();
+
+        const SimulationSnapshot<State>& snapshot = snapshots.GetReadBuffer();
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - snapshot.time).count();
+        double length = std::chrono::duration<double>(step).count();
+
+        alpha = (float)std::clamp(elapsed / length, 0.0, 1.0);
+        sampledTick = snapshot.tick;
+
+        return State::Interpolate(snapshot.previous, snapshot.current, alpha);
+    }
+
+    uint64_t GetTick() const
+    {
+        return sampledTick;
+    }
+
+    float GetAlpha() const
+    {
+        return alpha;
+    }
+
+    void LogSummary() const
+    {
+        if (ticks == 0)
+            return;
+
+        Logger_WriteConsole(std::format("Simulation ran {} ticks at {:.0f} Hz, {} dropped while catching up", ticks, 1.0 / std::chrono::duration<double>(step).count(), droppedTicks), LogLevel::INFO);
+    }
+
+private:
+
+    TickFunction tick;
+    State state;
+    std::chrono::steady_clock::duration step = {};
+
+    TripleBuffer<SimulationSnapshot<State>> snapshots;
+
+    uint64_t ticks = 0;
+    uint64_t droppedTicks = 0;
+
+    uint64_t sampledTick = 0;
+    float alpha = 0.0f;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stop = false;
+    std::thread worker;
+
+    void Run()
+    {
+        TERRA_PROFILE_THREAD("Simulation");
+
+        double seconds = std::chrono::duration<double>(step).count();
+        auto next = std::chrono::steady_clock::now();
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                if (cv.wait_until(lock, next, [this] { return stop; }))
+                    return;
+            }
+
+            {
+                TERRA_PROFILE_SCOPE("SimulationTick");
+
+                State previous = state;
+
+                tick(state, seconds);
+                ticks++;
+
+                SimulationSnapshot<State>& snapshot = snapshots.GetWriteBuffer();
+
+                snapshot.previous = previous;
+                snapshot.current = state;
+                snapshot.tick = ticks;
+                snapshot.time = next;
+
+                snapshots.Publish();
+            }
+
+            next += step;
+
+            auto now = std::chrono::steady_clock::now();
+
+            if (now - next > step * SIMULATION_MAX_CATCH_UP)
+            {
+                droppedTicks += (uint64_t)((now - next) / step);
+                next = now;
+            }
+        }
+    }
+};
+
+#endif // !FIXED_TIMESTEP_SIMULATION_HPP
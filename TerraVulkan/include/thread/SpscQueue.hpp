@@ -0,0 +1,69 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+
+#define SPSC_CACHE_LINE 64
+
+// Capacity must be a power of two
+template<typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+
+    bool Push(const T& value)
+    {
+        size_t tail = this->tail.load(std::memory_order_relaxed);
+
+        if (tail - cachedHead >= Capacity)
+        {
+            cachedHead = head.load(std::memory_order_acquire);
+
+            if (tail - cachedHead >= Capacity)
+                return false;
+        }
+
+        slots[tail & (Capacity - 1)] = value;
+        this->tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool Pop(T& value)
+    {
+        size_t head = this->head.load(std::memory_order_relaxed);
+
+        if (head == cachedTail)
+        {
+            cachedTail = tail.load(std::memory_order_acquire);
+
+            if (head == cachedTail)
+                return false;
+        }
+
+        value = slots[head & (Capacity - 1)];
+        this->head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    size_t Size() const
+    {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+private:
+
+    std::array<T, Capacity> slots = {};
+
+    alignas(SPSC_CACHE_LINE) std::atomic<size_t> head = 0;
+    size_t cachedTail = 0;
+
+    alignas(SPSC_CACHE_LINE) std::atomic<size_t> tail = 0;
+    size_t cachedHead = 0;
+};
+
+#endif // !SPSC_QUEUE_HPP
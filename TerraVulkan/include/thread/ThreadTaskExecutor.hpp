@@ -34,20 +34,24 @@ public:
 
     void Terminate()
     {
-        std::unique_lock<std::mutex> lock(mutex);
-        stop = true;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            stop = true;
+        }
+
         cv.notify_all();
 
-        worker.join();
+        if (worker.joinable())
+            worker.join();
     }
 
 private:
 
-    std::thread worker;
     std::mutex mutex;
     std::condition_variable cv;
     std::queue<std::function<void()>> tasks;
     bool stop = false;
+    std::thread worker;
 
     void run()
     {
@@ -0,0 +1,55 @@
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+
+template<typename T>
+class TripleBuffer
+{
+
+public:
+
+    TripleBuffer(const T& initial = {})
+    {
+        buffers.fill(initial);
+    }
+
+    T& GetWriteBuffer()
+    {
+        return buffers[writeIndex];
+    }
+
+    void Publish()
+    {
+        writeIndex = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    bool Update()
+    {
+        if ((middle.load(std::memory_order_relaxed) & FRESH) == 0)
+            return false;
+
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX;
+
+        return true;
+    }
+
+    const T& GetReadBuffer() const
+    {
+        return buffers[readIndex];
+    }
+
+private:
+
+    static constexpr uint32_t INDEX = 0x3;
+    static constexpr uint32_t FRESH = 0x4;
+
+    std::array<T, 3> buffers = {};
+
+    uint32_t writeIndex = 0;
+    std::atomic<uint32_t> middle = 1;
+    uint32_t readIndex = 2;
+};
+
+#endif // !TRIPLE_BUFFER_HPP
@@ -0,0 +1,459 @@
+#ifndef BLOCK_COMPRESSION_HPP
+#define BLOCK_COMPRESSION_HPP
+
+#include <cmath>
+#include <array>
+#include <vector>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include "util/ImageLoader.hpp"
+
+#define BLOCK_COMPRESSION_POWER_ITERATIONS 8
+
+enum class TextureCompression : uint8_t
+{
+    NONE,
+    BC1,
+    BC7
+};
+
+namespace BlockCompression
+{
+    const int bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    const char* GetName(TextureCompression compression)
+    {
+        switch (compression)
+        {
+        case TextureCompression::BC1:
+            return "BC1";
+        case TextureCompression::BC7:
+            return "BC7";
+        default:
+            return "RGBA8";
+        }
+    }
+
+    size_t GetBlockSize(TextureCompression compression)
+    {
+        return compression == TextureCompression::BC1 ? 8 : 16;
+    }
+
+    size_t GetLevelSize(TextureCompression compression, uint32_t width, uint32_t height)
+    {
+        if (compression == TextureCompression::NONE)
+            return (size_t)width * height * 4;
+
+        return (size_t)((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(compression);
+    }
+
+    template<int Channels>
+    void GetPrincipalAxis(const uint8_t* block, const bool* include, float* mean, float* axis)
+    {
+        int count = 0;
+
+        std::fill_n(mean, Channels, 0.0f);
+
+        for (int i = 0; i < 16; i++)
+        {
+            if (!include[i])
+                continue;
+
+            for (int c = 0; c < Channels; c++)
+                mean[c] += block[i * 4 + c];
+
+            count++;
+        }
+
+        for (int c = 0; c < Channels; c++)
+            mean[c] /= std::max(count, 1);
+
+        float covariance[Channels][Channels] = {};
+
+        for (int i = 0; i < 16; i++)
+        {
+            if (!include[i])
+                continue;
+
+            for (int a = 0; a < Channels; a++)
+            {
+                for (int b = 0; b < Channels; b++)
+                    covariance[a][b] += (block[i * 4 + a] - mean[a]) * (block[i * 4 + b] - mean[b]);
+            }
+        }
+
+        std::fill_n(axis, Channels, 1.0f);
+
+        for (int iteration = 0; iteration < BLOCK_COMPRESSION_POWER_ITERATIONS; iteration++)
+        {
+            float next[Channels] = {};
+            float length = 0.0f;
+
+            for (int a = 0; a < Channels; a++)
+            {
+                for (int b = 0; b < Channels; b++)
+                    next[a] += covariance[a][b] * axis[b];
+
+                length += next[a] * next[a];
+            }
+
+            if (length < 1e-8f)
+                break;
+
+            length = std::sqrt(length);
+
+            for (int a = 0; a < Channels; a++)
+                axis[a] = next[a] / length;
+        }
+    }
+
+    uint16_t PackRGB565(const float* color)
+    {
+        int r = std::clamp((int)std::lround(color[0] * 31.0f / 255.0f), 0, 31);
+        int g = std::clamp((int)std::lround(color[1] * 63.0f / 255.0f), 0, 63);
+        int b = std::clamp((int)std::lround(color[2] * 31.0f / 255.0f), 0, 31);
+
+        return (uint16_t)((r << 11) | (g << 5) | b);
+    }
+
+    void UnpackRGB565(uint16_t packed, int* color)
+    {
+        int r = (packed >> 11) & 31;
+        int g = (packed >> 5) & 63;
+        int b = packed & 31;
+
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    void EncodeBC1Block(const uint8_t* block, uint8_t* output)
+    {
+        bool include[16];
+        bool transparent = false;
+        bool any = false;
+
+        for (int i = 0; i < 16; i++)
+        {
+            include[i] = block[i * 4 + 3] >= 128;
+            transparent |= !include[i];
+            any |= include[i];
+        }
+
+        uint16_t color0 = 0;
+        uint16_t color1 = 0;
+
+        if (any)
+        {
+            float mean[3], axis[3];
+            GetPrincipalAxis<3>(block, include, mean, axis);
+
+            float minimum = 1e30f, maximum = -1e30f;
+
+            for (int i = 0; i < 16; i++)
+            {
+                if (!include[i])
+                    continue;
+
+                float t = (block[i * 4 + 0] - mean[0]) * axis[0] + (block[i * 4 + 1] - mean[1]) * axis[1] + (block[i * 4 + 2] - mean[2]) * axis[2];
+
+                minimum = std::min(minimum, t);
+                maximum = std::max(maximum, t);
+            }
+
+            float inset = (maximum - minimum) / 16.0f;
+            float low[3], high[3];
+
+            for (int c = 0; c < 3; c++)
+            {
+                low[c] = mean[c] + axis[c] * (minimum + inset);
+                high[c] = mean[c] + axis[c] * (maximum - inset);
+            }
+
+            color0 = PackRGB565(high);
+            color1 = PackRGB565(low);
+        }
+
+        // Four colour mode needs color0 > color1, the three colour mode with a transparent index needs color0 <= color1
+        if ((color0 < color1) != transparent && color0 != color1)
+            std::swap(color0, color1);
+
+        int palette[4][3];
+        UnpackRGB565(color0, palette[0]);
+        UnpackRGB565(color1, palette[1]);
+
+        bool fourColor = color0 > color1;
+
+        for (int c = 0; c < 3; c++)
+        {
+            if (fourColor)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            else
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+
+        uint32_t indices = 0;
+
+        for (int i = 0; i < 16; i++)
+        {
+            int best = 3;
+
+            if (include[i])
+            {
+                int bestError = INT32_MAX;
+
+                for (int candidate = 0; candidate < (fourColor ? 4 : 3); candidate++)
+                {
+                    int error = 0;
+
+                    for (int c = 0; c < 3; c++)
+                    {
+                        int difference = block[i * 4 + c] - palette[candidate][c];
+                        error += difference * difference;
+                    }
+
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        best = candidate;
+                    }
+                }
+            }
+
+            indices |= (uint32_t)best << (i * 2);
+        }
+
+        output[0] = color0 & 0xFF;
+        output[1] = color0 >> 8;
+        output[2] = color1 & 0xFF;
+        output[3] = color1 >> 8;
+
+        memcpy(output + 4, &indices, 4);
+    }
+
+    struct BitWriter
+    {
+        uint8_t* output;
+        uint32_t position = 0;
+
+        void Write(uint32_t value, uint32_t bits)
+        {
+            for (uint32_t i = 0; i < bits; i++, position++)
+            {
+                if (value & (1u << i))
+                    output[position / 8] |= (uint8_t)(1u << (position % 8));
+            }
+        }
+    };
+
+    struct BC7Mode6Candidate
+    {
+        int quantized[2][4] = {};
+        int pBits[2] = {};
+        int indices[16] = {};
+        long long error = LLONG_MAX;
+    };
+
+    BC7Mode6Candidate EvaluateBC7Mode6(const uint8_t* block, const float endpoints[2][4])
+    {
+        BC7Mode6Candidate best = {};
+
+        for (int pBits = 0; pBits < 4; pBits++)
+        {
+            BC7Mode6Candidate candidate = {};
+            int expanded[2][4];
+
+            candidate.pBits[0] = pBits & 1;
+            candidate.pBits[1] = pBits >> 1;
+            candidate.error = 0;
+
+            for (int e = 0; e < 2; e++)
+            {
+                for (int c = 0; c < 4; c++)
+                {
+                    candidate.quantized[e][c] = std::clamp((int)std::lround((endpoints[e][c] - candidate.pBits[e]) / 2.0f), 0, 127);
+                    expanded[e][c] = (candidate.quantized[e][c] << 1) | candidate.pBits[e];
+                }
+            }
+
+            for (int i = 0; i < 16; i++)
+            {
+                int bestPixelError = INT32_MAX;
+
+                for (int index = 0; index < 16; index++)
+                {
+                    int pixelError = 0;
+
+                    for (int c = 0; c < 4; c++)
+                    {
+                        int value = ((64 - bc7Weights[index]) * expanded[0][c] + bc7Weights[index] * expanded[1][c] + 32) >> 6;
+                        int difference = block[i * 4 + c] - value;
+
+                        pixelError += difference * difference;
+                    }
+
+                    if (pixelError < bestPixelError)
+                    {
+                        bestPixelError = pixelError;
+                        candidate.indices[i] = index;
+                    }
+                }
+
+                candidate.error += bestPixelError;
+            }
+
+            if (candidate.error < best.error)
+                best = candidate;
+        }
+
+        return best;
+    }
+
+    // BC7 mode 6: one subset, RGBA endpoints with seven bits plus a p-bit each, and 4-bit indices
+    void EncodeBC7Block(const uint8_t* block, uint8_t* output)
+    {
+        bool include[16];
+        std::fill_n(include, 16, true);
+
+        float mean[4], axis[4];
+        GetPrincipalAxis<4>(block, include, mean, axis);
+
+        float minimum = 1e30f, maximum = -1e30f;
+
+        for (int i = 0; i < 16; i++)
+        {
+            float t = 0.0f;
+
+            for (int c = 0; c < 4; c++)
+                t += (block[i * 4 + c] - mean[c]) * axis[c];
+
+            minimum = std::min(minimum, t);
+            maximum = std::max(maximum, t);
+        }
+
+        float endpoints[2][4];
+
+        for (int c = 0; c < 4; c++)
+        {
+            endpoints[0][c] = mean[c] + axis[c] * minimum;
+            endpoints[1][c] = mean[c] + axis[c] * maximum;
+        }
+
+        BC7Mode6Candidate best = EvaluateBC7Mode6(block, endpoints);
+
+        for (int iteration = 0; iteration < 2 && best.error > 0; iteration++)
+        {
+            float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+            float ax[4] = {}, bx[4] = {};
+
+            for (int i = 0; i < 16; i++)
+            {
+                float b = bc7Weights[best.indices[i]] / 64.0f;
+                float a = 1.0f - b;
+
+                aa += a * a;
+                ab += a * b;
+                bb += b * b;
+
+                for (int c = 0; c < 4; c++)
+                {
+                    ax[c] += a * block[i * 4 + c];
+                    bx[c] += b * block[i * 4 + c];
+                }
+            }
+
+            float determinant = aa * bb - ab * ab;
+
+            if (std::abs(determinant) < 1e-6f)
+                break;
+
+            for (int c = 0; c < 4; c++)
+            {
+                endpoints[0][c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+                endpoints[1][c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+            }
+
+            BC7Mode6Candidate refined = EvaluateBC7Mode6(block, endpoints);
+
+            if (refined.error >= best.error)
+                break;
+
+            best = refined;
+        }
+
+        // The first index is stored with an implicit zero high bit, so flip the endpoints if it would be set
+        if (best.indices[0] >= 8)
+        {
+            std::swap(best.quantized[0], best.quantized[1]);
+            std::swap(best.pBits[0], best.pBits[1]);
+
+            for (int& index : best.indices)
+                index = 15 - index;
+        }
+
+        memset(output, 0, 16);
+
+        BitWriter writer = { output };
+
+        writer.Write(1u << 6, 7);
+
+        for (int c = 0; c < 4; c++)
+        {
+            writer.Write(best.quantized[0][c], 7);
+            writer.Write(best.quantized[1][c], 7);
+        }
+
+        writer.Write(best.pBits[0], 1);
+        writer.Write(best.pBits[1], 1);
+        writer.Write(best.indices[0], 3);
+
+        for (int i = 1; i < 16; i++)
+            writer.Write(best.indices[i], 4);
+    }
+
+    void FetchBlock(const ImageData& image, uint32_t blockX, uint32_t blockY, uint8_t* block)
+    {
+        for (uint32_t y = 0; y < 4; y++)
+        {
+            for (uint32_t x = 0; x < 4; x++)
+            {
+                uint32_t sourceX = std::min(blockX * 4 + x, image.width - 1);
+                uint32_t sourceY = std::min(blockY * 4 + y, image.height - 1);
+
+                memcpy(block + (y * 4 + x) * 4, &image.pixels[((size_t)sourceY * image.width + sourceX) * 4], 4);
+            }
+        }
+    }
+
+    void EncodeRows(const ImageData& image, TextureCompression compression, uint32_t firstRow, uint32_t lastRow, uint8_t* output)
+    {
+        uint32_t blocksWide = (image.width + 3) / 4;
+        size_t blockSize = GetBlockSize(compression);
+        uint8_t block[64];
+
+        for (uint32_t blockY = firstRow; blockY < lastRow; blockY++)
+        {
+            for (uint32_t blockX = 0; blockX < blocksWide; blockX++)
+            {
+                FetchBlock(image, blockX, blockY, block);
+
+                uint8_t* destination = output + ((size_t)blockY * blocksWide + blockX) * blockSize;
+
+                if (compression == TextureCompression::BC1)
+                    EncodeBC1Block(block, destination);
+                else
+                    EncodeBC7Block(block, destination);
+            }
+        }
+    }
+}
+
+#endif // !BLOCK_COMPRESSION_HPP
@@ -0,0 +1,150 @@
+#ifndef FILE_WATCHER_HPP
+#define FILE_WATCHER_HPP
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <filesystem>
+#include <unordered_map>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#elif defined(__linux__)
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+#define FILE_WATCHER_TIMEOUT_MS 100
+
+class FileWatcher
+{
+
+public:
+
+    FileWatcher(const std::string& directory, std::function<void(const std::string&)> callback) : directory(directory), callback(std::move(callback)), worker([this] { Run(); })
+    {
+
+    }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    ~FileWatcher()
+    {
+        Stop();
+    }
+
+    void Stop()
+    {
+        running = false;
+
+        if (worker.joinable())
+            worker.join();
+    }
+
+private:
+
+    std::string directory;
+    std::function<void(const std::string&)> callback;
+    std::unordered_map<std::string, std::filesystem::file_time_type> snapshot;
+    std::atomic<bool> running = true;
+    std::thread worker;
+
+    void Scan(bool notify)
+    {
+        std::error_code error;
+
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+        {
+            if (!entry.is_regular_file(error))
+                continue;
+
+            std::string path = entry.path().lexically_normal().generic_string();
+            auto time = entry.last_write_time(error);
+            auto found = snapshot.find(path);
+
+            if (found != snapshot.end() && found->second == time)
+                continue;
+
+            snapshot[path] = time;
+
+            if (notify)
+                callback(path);
+        }
+    }
+
+    void Run()
+    {
+#ifdef _WIN32
+        Scan(false);
+
+        HANDLE change = FindFirstChangeNotificationA(directory.c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+
+        if (change == INVALID_HANDLE_VALUE)
+            return;
+
+        while (running)
+        {
+            if (WaitForSingleObject(change, FILE_WATCHER_TIMEOUT_MS) != WAIT_OBJECT_0)
+                continue;
+
+            Scan(true);
+
+            FindNextChangeNotification(change);
+        }
+
+        FindCloseChangeNotification(change);
+#elif defined(__linux__)
+        int descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+        if (descriptor < 0 || inotify_add_watch(descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+        {
+            if (descriptor >= 0)
+                close(descriptor);
+
+            return;
+        }
+
+        alignas(inotify_event) char buffer[4096];
+
+        while (running)
+        {
+            pollfd request = { descriptor, POLLIN, 0 };
+
+            if (poll(&request, 1, FILE_WATCHER_TIMEOUT_MS) <= 0)
+                continue;
+
+            ssize_t length = read(descriptor, buffer, sizeof(buffer));
+
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+
+                if (event->len > 0)
+                    callback((std::filesystem::path(directory) / event->name).lexically_normal().generic_string());
+
+                offset += sizeof(inotify_event) + event->len;
+            }
+        }
+
+        close(descriptor);
+#else
+        Scan(false);
+
+        while (running)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(FILE_WATCHER_TIMEOUT_MS));
+
+            Scan(true);
+        }
+#endif
+    }
+};
+
+#endif // !FILE_WATCHER_HPP
@@ -171,4 +171,10 @@
 
 #define GL_POLL_EVENTS() glfwPollEvents()
 
+#define GL_WAIT_EVENTS() glfwWaitEvents()
+
+#define GL_WAIT_EVENTS_TIMEOUT(timeout) glfwWaitEventsTimeout(timeout)
+
+#define GL_POST_EMPTY_EVENT() glfwPostEmptyEvent()
+
 #endif // !GL_HPP
\ No newline at end of file
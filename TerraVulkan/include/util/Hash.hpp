@@ -0,0 +1,38 @@
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#define HASH_FNV_OFFSET 14695981039346656037ull
+#define HASH_FNV_PRIME 1099511628211ull
+
+namespace Hash
+{
+    uint64_t FNV1a(const void* data, size_t size, uint64_t hash = HASH_FNV_OFFSET)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= HASH_FNV_PRIME;
+        }
+
+        return hash;
+    }
+
+    template<typename T>
+    uint64_t Combine(uint64_t hash, const T& value)
+    {
+        return FNV1a(&value, sizeof(T), hash);
+    }
+
+    uint64_t Combine(uint64_t hash, const std::string& value)
+    {
+        return FNV1a(value.data(), value.size(), hash);
+    }
+}
+
+#endif // !HASH_HPP
@@ -0,0 +1,132 @@
+#ifndef IMAGE_HELPER_HPP
+#define IMAGE_HELPER_HPP
+
+#include "core/VulkanManager.hpp"
+#include "util/MeshHelper.hpp"
+
+namespace ImageHelper
+{
+    VkCommandBuffer BeginSingleTimeCommands()
+    {
+        VkCommandBufferAllocateInfo allocationInformation = {};
+
+        allocationInformation.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocationInformation.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocationInformation.commandPool = VulkanManager::commandPool;
+        allocationInformation.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+        vkAllocateCommandBuffers(VulkanManager::device, &allocationInformation, &commandBuffer);
+
+        VkCommandBufferBeginInfo beginInformation = {};
+
+        beginInformation.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInformation.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        vkBeginCommandBuffer(commandBuffer, &beginInformation);
+
+        return commandBuffer;
+    }
+
+    void EndSingleTimeCommands(VkCommandBuffer commandBuffer)
+    {
+        vkEndCommandBuffer(commandBuffer);
+
+        VkSubmitInfo submissionInformation = {};
+
+        submissionInformation.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submissionInformation.commandBufferCount = 1;
+        submissionInformation.pCommandBuffers = &commandBuffer;
+
+        vkQueueSubmit(VulkanManager::graphicsQueue, 1, &submissionInformation, VK_NULL_HANDLE);
+        vkQueueWaitIdle(VulkanManager::graphicsQueue);
+
+        vkFreeCommandBuffers(VulkanManager::device, VulkanManager::commandPool, 1, &commandBuffer);
+    }
+
+    void GenerateImage(uint32_t width, uint32_t height, uint32_t mipLevels, uint32_t layers, VkFormat format, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory)
+    {
+        VkImageCreateInfo imageInformation = {};
+
+        imageInformation.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInformation.imageType = VK_IMAGE_TYPE_2D;
+        imageInformation.extent = { width, height, 1 };
+        imageInformation.mipLevels = mipLevels;
+        imageInformation.arrayLayers = layers;
+        imageInformation.format = format;
+        imageInformation.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInformation.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInformation.usage = usage;
+        imageInformation.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInformation.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateImage(VulkanManager::device, &imageInformation, VULKAN_ALLOCATOR, &image) != VK_SUCCESS)
+            Logger_ThrowError("VK_FAILURE", "Failed to create image!", true);
+
+        VkMemoryRequirements memoryRequirements;
+        vkGetImageMemoryRequirements(VulkanManager::device, image, &memoryRequirements);
+
+        VkMemoryAllocateInfo allocationInformation = {};
+
+        allocationInformation.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocationInformation.allocationSize = memoryRequirements.size;
+        allocationInformation.memoryTypeIndex = MeshHelper::GetMemoryType(memoryRequirements.memoryTypeBits, properties);
+
+        if (vkAllocateMemory(VulkanManager::device, &allocationInformation, VULKAN_ALLOCATOR, &imageMemory) != VK_SUCCESS)
+            Logger_ThrowError("VK_FAILURE", "Failed to allocate image memory!", true);
+
+        vkBindImageMemory(VulkanManager::device, image, imageMemory, 0);
+    }
+
+    VkImageViewCreateInfo GetImageViewInformation(VkImage image, VkImageViewType type, VkFormat format, VkImageAspectFlags aspect, uint32_t mipLevels, uint32_t layers)
+    {
+        VkImageViewCreateInfo viewInformation = {};
+
+        viewInformation.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInformation.image = image;
+        viewInformation.viewType = type;
+        viewInformation.format = format;
+        viewInformation.subresourceRange.aspectMask = aspect;
+        viewInformation.subresourceRange.baseMipLevel = 0;
+        viewInformation.subresourceRange.levelCount = mipLevels;
+        viewInformation.subresourceRange.baseArrayLayer = 0;
+        viewInformation.subresourceRange.layerCount = layers;
+
+        return viewInformation;
+    }
+
+    VkImageView CreateImageView(VkImage image, VkImageViewType type, VkFormat format, VkImageAspectFlags aspect, uint32_t mipLevels, uint32_t layers)
+    {
+        VkImageViewCreateInfo viewInformation = GetImageViewInformation(image, type, format, aspect, mipLevels, layers);
+        VkImageView view = VK_NULL_HANDLE;
+
+        if (vkCreateImageView(VulkanManager::device, &viewInformation, VULKAN_ALLOCATOR, &view) != VK_SUCCESS)
+            Logger_ThrowError("VK_FAILURE", "Failed to create image view!", true);
+
+        return view;
+    }
+
+    void TransitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageAspectFlags aspect, uint32_t baseMipLevel, uint32_t levelCount, uint32_t layers,
+        VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags sourceAccess, VkAccessFlags destinationAccess, VkPipelineStageFlags sourceStage, VkPipelineStageFlags destinationStage)
+    {
+        VkImageMemoryBarrier barrier = {};
+
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = aspect;
+        barrier.subresourceRange.baseMipLevel = baseMipLevel;
+        barrier.subresourceRange.levelCount = levelCount;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = layers;
+        barrier.srcAccessMask = sourceAccess;
+        barrier.dstAccessMask = destinationAccess;
+
+        vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+}
+
+#endif // !IMAGE_HELPER_HPP
@@ -0,0 +1,210 @@
+#ifndef IMAGE_LOADER_HPP
+#define IMAGE_LOADER_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <cctype>
+#include <cstdint>
+#include <algorithm>
+#include <filesystem>
+
+struct ImageData
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    std::vector<uint8_t> pixels = {};
+
+    bool Valid() const
+    {
+        return width > 0 && height > 0 && pixels.size() == (size_t)width * height * 4;
+    }
+};
+
+namespace ImageLoader
+{
+    bool LoadTGA(const std::vector<uint8_t>& file, ImageData& image)
+    {
+        if (file.size() < 18)
+            return false;
+
+        uint8_t idLength = file[0];
+        uint8_t colorMapType = file[1];
+        uint8_t imageType = file[2];
+        uint32_t width = file[12] | (file[13] << 8);
+        uint32_t height = file[14] | (file[15] << 8);
+        uint8_t bitsPerPixel = file[16];
+        bool topLeft = (file[17] & 0x20) != 0;
+
+        bool compressed = imageType == 10 || imageType == 11;
+        bool grayscale = imageType == 3 || imageType == 11;
+
+        if (colorMapType != 0 || (imageType != 2 && imageType != 3 && imageType != 10 && imageType != 11))
+            return false;
+
+        if ((grayscale && bitsPerPixel != 8) || (!grayscale && bitsPerPixel != 24 && bitsPerPixel != 32) || width == 0 || height == 0)
+            return false;
+
+        size_t bytesPerPixel = bitsPerPixel / 8;
+        size_t position = 18 + idLength;
+        size_t pixelCount = (size_t)width * height;
+
+        std::vector<uint8_t> raw(pixelCount * bytesPerPixel);
+
+        if (!compressed)
+        {
+            if (file.size() < position + raw.size())
+                return false;
+
+            std::copy(file.begin() + position, file.begin() + position + raw.size(), raw.begin());
+        }
+        else
+        {
+            for (size_t pixel = 0; pixel < pixelCount;)
+            {
+                if (position >= file.size())
+                    return false;
+
+                uint8_t packet = file[position++];
+                size_t count = (packet & 0x7F) + 1;
+                bool run = (packet & 0x80) != 0;
+
+                if (pixel + count > pixelCount || position + (run ? 1 : count) * bytesPerPixel > file.size())
+                    return false;
+
+                for (size_t i = 0; i < count; i++, pixel++)
+                {
+                    std::copy_n(file.begin() + position, bytesPerPixel, raw.begin() + pixel * bytesPerPixel);
+
+                    if (!run)
+                        position += bytesPerPixel;
+                }
+
+                if (run)
+                    position += bytesPerPixel;
+            }
+        }
+
+        image.width = width;
+        image.height = height;
+        image.pixels.resize(pixelCount * 4);
+
+        for (uint32_t y = 0; y < height; y++)
+        {
+            uint32_t sourceRow = topLeft ? y : height - 1 - y;
+
+            for (uint32_t x = 0; x < width; x++)
+            {
+                const uint8_t* source = &raw[((size_t)sourceRow * width + x) * bytesPerPixel];
+                uint8_t* destination = &image.pixels[((size_t)y * width + x) * 4];
+
+                if (grayscale)
+                {
+                    destination[0] = destination[1] = destination[2] = source[0];
+                    destination[3] = 255;
+                }
+                else
+                {
+                    destination[0] = source[2];
+                    destination[1] = source[1];
+                    destination[2] = source[0];
+                    destination[3] = bytesPerPixel == 4 ? source[3] : 255;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool LoadPPM(const std::vector<uint8_t>& file, ImageData& image)
+    {
+        size_t position = 2;
+
+        auto readNumber = [&](uint32_t& value) -> bool
+        {
+            while (position < file.size() && (isspace(file[position]) || file[position] == '#'))
+            {
+                if (file[position] == '#')
+                {
+                    while (position < file.size() && file[position] != '\n')
+                        position++;
+                }
+                else
+                    position++;
+            }
+
+            if (position >= file.size() || !isdigit(file[position]))
+                return false;
+
+            value = 0;
+
+            while (position < file.size() && isdigit(file[position]))
+                value = value * 10 + (file[position++] - '0');
+
+            return true;
+        };
+
+        if (file.size() < 2 || file[0] != 'P' || file[1] != '6')
+            return false;
+
+        uint32_t width, height, maximum;
+
+        if (!readNumber(width) || !readNumber(height) || !readNumber(maximum) || maximum != 255 || width == 0 || height == 0)
+            return false;
+
+        position++;
+
+        size_t pixelCount = (size_t)width * height;
+
+        if (file.size() < position + pixelCount * 3)
+            return false;
+
+        image.width = width;
+        image.height = height;
+        image.pixels.resize(pixelCount * 4);
+
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            image.pixels[i * 4 + 0] = file[position + i * 3 + 0];
+            image.pixels[i * 4 + 1] = file[position + i * 3 + 1];
+            image.pixels[i * 4 + 2] = file[position + i * 3 + 2];
+            image.pixels[i * 4 + 3] = 255;
+        }
+
+        return true;
+    }
+
+    bool ReadFile(const std::string& path, std::vector<uint8_t>& file)
+    {
+        std::ifstream stream(path, std::ios::binary);
+
+        if (!stream.is_open())
+            return false;
+
+        file.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+
+        return true;
+    }
+
+    bool Load(const std::vector<uint8_t>& file, const std::string& extension, ImageData& image)
+    {
+        if (extension == ".tga")
+            return LoadTGA(file, image);
+
+        if (extension == ".ppm")
+            return LoadPPM(file, image);
+
+        return false;
+    }
+
+    bool Load(const std::string& path, ImageData& image)
+    {
+        std::vector<uint8_t> file;
+
+        return ReadFile(path, file) && Load(file, std::filesystem::path(path).extension().string(), image);
+    }
+}
+
+#endif // !IMAGE_LOADER_HPP
@@ -0,0 +1,136 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <string>
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+class MappedFile
+{
+
+public:
+
+    MappedFile() = default;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+        Close();
+    }
+
+    bool Open(const std::string& path)
+    {
+        Close();
+
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER fileSize = {};
+
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            Close();
+            return false;
+        }
+
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (mapping == nullptr)
+        {
+            Close();
+            return false;
+        }
+
+        data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        size = (size_t)fileSize.QuadPart;
+#else
+        int descriptor = open(path.c_str(), O_RDONLY);
+
+        if (descriptor < 0)
+            return false;
+
+        struct stat status = {};
+
+        if (fstat(descriptor, &status) != 0 || status.st_size == 0)
+        {
+            close(descriptor);
+            return false;
+        }
+
+        void* view = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        close(descriptor);
+
+        data = view == MAP_FAILED ? nullptr : view;
+        size = (size_t)status.st_size;
+#endif
+
+        if (data == nullptr)
+        {
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void Close()
+    {
+#ifdef _WIN32
+        if (data != nullptr)
+            UnmapViewOfFile(data);
+
+        if (mapping != nullptr)
+            CloseHandle(mapping);
+
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data != nullptr)
+            munmap(data, size);
+#endif
+
+        data = nullptr;
+        size = 0;
+    }
+
+    const void* Data() const
+    {
+        return data;
+    }
+
+    size_t Size() const
+    {
+        return size;
+    }
+
+private:
+
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    void* data = nullptr;
+    size_t size = 0;
+};
+
+#endif // !MAPPED_FILE_HPP
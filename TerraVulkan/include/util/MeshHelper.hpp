@@ -29,7 +29,7 @@ namespace MeshHelper
         bufferInformation.usage = usage;
         bufferInformation.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-        if (vkCreateBuffer(VulkanManager::device, &bufferInformation, nullptr, &buffer) != VK_SUCCESS) 
+        if (vkCreateBuffer(VulkanManager::device, &bufferInformation, VULKAN_ALLOCATOR, &buffer) != VK_SUCCESS) 
             Logger_ThrowError("VK_FAILURE", "Failed to create buffer!", true);
 
         VkMemoryRequirements memoryRequirements;
@@ -41,7 +41,7 @@ namespace MeshHelper
         allocationInformation.allocationSize = memoryRequirements.size;
         allocationInformation.memoryTypeIndex = GetMemoryType(memoryRequirements.memoryTypeBits, properties);
 
-        if (vkAllocateMemory(VulkanManager::device, &allocationInformation, nullptr, &bufferMemory) != VK_SUCCESS)
+        if (vkAllocateMemory(VulkanManager::device, &allocationInformation, VULKAN_ALLOCATOR, &bufferMemory) != VK_SUCCESS)
             Logger_ThrowError("VK_FAILURE", "Failed to allocate buffer memory!", true);
 
         vkBindBufferMemory(VulkanManager::device, buffer, bufferMemory, 0);
@@ -0,0 +1,321 @@
+#ifndef MIP_GENERATOR_HPP
+#define MIP_GENERATOR_HPP
+
+#include <cmath>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "util/ImageLoader.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#include <immintrin.h>
+#define MIP_GENERATOR_AVX
+#endif
+
+#define SRGB_ENCODE_TABLE_SIZE 4096
+#define KAISER_TAPS 6
+#define KAISER_ALPHA 4.0
+
+enum class MipFilter : uint8_t
+{
+    BOX,
+    KAISER
+};
+
+struct LinearImage
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    std::vector<float> pixels = {};
+};
+
+namespace MipGenerator
+{
+    const std::array<float, 256>& GetDecodeTable()
+    {
+        static const std::array<float, 256> table = []
+        {
+            std::array<float, 256> values = {};
+
+            for (int i = 0; i < 256; i++)
+            {
+                double c = i / 255.0;
+                values[i] = (float)(c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+            }
+
+            return values;
+        }();
+
+        return table;
+    }
+
+    const std::array<uint8_t, SRGB_ENCODE_TABLE_SIZE>& GetEncodeTable()
+    {
+        static const std::array<uint8_t, SRGB_ENCODE_TABLE_SIZE> table = []
+        {
+            std::array<uint8_t, SRGB_ENCODE_TABLE_SIZE> values = {};
+
+            for (int i = 0; i < SRGB_ENCODE_TABLE_SIZE; i++)
+            {
+                double l = i / (double)(SRGB_ENCODE_TABLE_SIZE - 1);
+                double c = l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+
+                values[i] = (uint8_t)std::clamp((int)std::lround(c * 255.0), 0, 255);
+            }
+
+            return values;
+        }();
+
+        return table;
+    }
+
+    LinearImage ToLinear(const ImageData& image)
+    {
+        const auto& decode = GetDecodeTable();
+
+        LinearImage linear = { image.width, image.height, std::vector<float>(image.pixels.size()) };
+
+        for (size_t i = 0; i < image.pixels.size(); i += 4)
+        {
+            linear.pixels[i + 0] = decode[image.pixels[i + 0]];
+            linear.pixels[i + 1] = decode[image.pixels[i + 1]];
+            linear.pixels[i + 2] = decode[image.pixels[i + 2]];
+            linear.pixels[i + 3] = image.pixels[i + 3] / 255.0f;
+        }
+
+        return linear;
+    }
+
+    ImageData ToSRGB(const LinearImage& linear)
+    {
+        const auto& encode = GetEncodeTable();
+
+        ImageData image = { linear.width, linear.height, std::vector<uint8_t>(linear.pixels.size()) };
+
+        auto quantize = [](float value, int scale)
+        {
+            return std::clamp((int)(value * scale + 0.5f), 0, scale);
+        };
+
+        for (size_t i = 0; i < linear.pixels.size(); i += 4)
+        {
+            image.pixels[i + 0] = encode[quantize(linear.pixels[i + 0], SRGB_ENCODE_TABLE_SIZE - 1)];
+            image.pixels[i + 1] = encode[quantize(linear.pixels[i + 1], SRGB_ENCODE_TABLE_SIZE - 1)];
+            image.pixels[i + 2] = encode[quantize(linear.pixels[i + 2], SRGB_ENCODE_TABLE_SIZE - 1)];
+            image.pixels[i + 3] = (uint8_t)quantize(linear.pixels[i + 3], 255);
+        }
+
+        return image;
+    }
+
+#ifdef MIP_GENERATOR_AVX
+    bool HasAvx()
+    {
+        static const bool supported = []
+        {
+            int information[4] = {};
+            __cpuid(information, 1);
+
+            bool avx = (information[2] & (1 << 28)) != 0;
+            bool osxsave = (information[2] & (1 << 27)) != 0;
+
+            return avx && osxsave && (_xgetbv(0) & 0x6) == 0x6;
+        }();
+
+        return supported;
+    }
+#endif
+
+    LinearImage DownsampleBox(const LinearImage& source)
+    {
+        uint32_t width = std::max(source.width / 2, 1u);
+        uint32_t height = std::max(source.height / 2, 1u);
+
+        LinearImage result = { width, height, std::vector<float>((size_t)width * height * 4) };
+
+        for (uint32_t y = 0; y < height; y++)
+        {
+            const float* row0 = &source.pixels[(size_t)std::min(y * 2, source.height - 1) * source.width * 4];
+            const float* row1 = &source.pixels[(size_t)std::min(y * 2 + 1, source.height - 1) * source.width * 4];
+            float* destination = &result.pixels[(size_t)y * width * 4];
+
+            uint32_t x = 0;
+
+#ifdef MIP_GENERATOR_AVX
+            if (source.width >= 2 && HasAvx())
+            {
+                const __m256 quarter = _mm256_set1_ps(0.25f);
+
+                for (; x + 2 <= width && (x + 2) * 2 <= source.width; x += 2)
+                {
+                    __m256 low = _mm256_add_ps(_mm256_loadu_ps(row0 + x * 8), _mm256_loadu_ps(row1 + x * 8));
+                    __m256 high = _mm256_add_ps(_mm256_loadu_ps(row0 + x * 8 + 8), _mm256_loadu_ps(row1 + x * 8 + 8));
+
+                    __m256 sum = _mm256_add_ps(_mm256_permute2f128_ps(low, high, 0x20), _mm256_permute2f128_ps(low, high, 0x31));
+
+                    _mm256_storeu_ps(destination + x * 4, _mm256_mul_ps(sum, quarter));
+                }
+            }
+#endif
+
+            for (; x < width; x++)
+            {
+                uint32_t x0 = std::min(x * 2, source.width - 1);
+                uint32_t x1 = std::min(x * 2 + 1, source.width - 1);
+
+                for (int c = 0; c < 4; c++)
+                    destination[x * 4 + c] = 0.25f * (row0[x0 * 4 + c] + row0[x1 * 4 + c] + row1[x0 * 4 + c] + row1[x1 * 4 + c]);
+            }
+        }
+
+        return result;
+    }
+
+    double BesselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+
+        for (int k = 1; k < 32; k++)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    // Kaiser windowed sinc taps for a 2:1 reduction, at source offsets -2.5 ... +2.5 from the destination pixel centre
+    const std::array<float, KAISER_TAPS>& GetKaiserWeights()
+    {
+        static const std::array<float, KAISER_TAPS> weights = []
+        {
+            std::array<float, KAISER_TAPS> values = {};
+            double total = 0.0;
+            double radius = KAISER_TAPS / 4.0;
+
+            for (int i = 0; i < KAISER_TAPS; i++)
+            {
+                double t = (i - (KAISER_TAPS - 1) / 2.0) / 2.0;
+                double sinc = t == 0.0 ? 1.0 : std::sin(3.14159265358979323846 * t) / (3.14159265358979323846 * t);
+                double ratio = t / radius;
+                double window = std::abs(ratio) >= 1.0 ? 0.0 : BesselI0(KAISER_ALPHA * std::sqrt(1.0 - ratio * ratio)) / BesselI0(KAISER_ALPHA);
+
+                values[i] = (float)(sinc * window);
+                total += values[i];
+            }
+
+            for (float& value : values)
+                value = (float)(value / total);
+
+            return values;
+        }();
+
+        return weights;
+    }
+
+    // Block textures tile, so the filter wraps around the edges instead of clamping
+    LinearImage DownsampleKaiser(const LinearImage& source)
+    {
+        const auto& weights = GetKaiserWeights();
+
+        uint32_t width = std::max(source.width / 2, 1u);
+        uint32_t height = std::max(source.height / 2, 1u);
+
+        auto wrap = [](int64_t value, uint32_t size) { return (uint32_t)(((value % size) + size) % size); };
+
+        LinearImage horizontal = { width, source.height, std::vector<float>((size_t)width * source.height * 4) };
+
+        for (uint32_t y = 0; y < source.height; y++)
+        {
+            const float* row = &source.pixels[(size_t)y * source.width * 4];
+            float* destination = &horizontal.pixels[(size_t)y * width * 4];
+
+            for (uint32_t x = 0; x < width; x++)
+            {
+                if (source.width == 1)
+                {
+                    std::copy_n(row, 4, destination);
+                    continue;
+                }
+
+                float sum[4] = {};
+
+                for (int k = 0; k < KAISER_TAPS; k++)
+                {
+                    const float* pixel = &row[wrap((int64_t)x * 2 - (KAISER_TAPS / 2 - 1) + k, source.width) * 4];
+
+                    for (int c = 0; c < 4; c++)
+                        sum[c] += weights[k] * pixel[c];
+                }
+
+                std::copy_n(sum, 4, destination + x * 4);
+            }
+        }
+
+        if (source.height == 1)
+            return horizontal;
+
+        LinearImage result = { width, height, std::vector<float>((size_t)width * height * 4) };
+        size_t rowLength = (size_t)width * 4;
+
+        for (uint32_t y = 0; y < height; y++)
+        {
+            const float* rows[KAISER_TAPS];
+
+            for (int k = 0; k < KAISER_TAPS; k++)
+                rows[k] = &horizontal.pixels[wrap((int64_t)y * 2 - (KAISER_TAPS / 2 - 1) + k, source.height) * rowLength];
+
+            float* destination = &result.pixels[y * rowLength];
+            size_t i = 0;
+
+#ifdef MIP_GENERATOR_AVX
+            for (; HasAvx() && i + 8 <= rowLength; i += 8)
+            {
+                __m256 sum = _mm256_setzero_ps();
+
+                for (int k = 0; k < KAISER_TAPS; k++)
+                    sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights[k]), _mm256_loadu_ps(rows[k] + i)));
+
+                _mm256_storeu_ps(destination + i, sum);
+            }
+#endif
+
+            for (; i < rowLength; i++)
+            {
+                float sum = 0.0f;
+
+                for (int k = 0; k < KAISER_TAPS; k++)
+                    sum += weights[k] * rows[k][i];
+
+                destination[i] = sum;
+            }
+        }
+
+        return result;
+    }
+
+    uint32_t GetLevelCount(uint32_t width, uint32_t height)
+    {
+        return static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+    }
+
+    std::vector<ImageData> Generate(const ImageData& image, MipFilter filter = MipFilter::KAISER)
+    {
+        std::vector<ImageData> levels = { image };
+        LinearImage current = ToLinear(image);
+
+        for (uint32_t level = 1; level < GetLevelCount(image.width, image.height); level++)
+        {
+            current = filter == MipFilter::BOX ? DownsampleBox(current) : DownsampleKaiser(current);
+            levels.push_back(ToSRGB(current));
+        }
+
+        return levels;
+    }
+}
+
+#endif // !MIP_GENERATOR_HPP
@@ -0,0 +1,289 @@
+#ifndef TEXTURE_PROCESSOR_HPP
+#define TEXTURE_PROCESSOR_HPP
+
+#include <latch>
+#include <atomic>
+#include <format>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <filesystem>
+#include "core/Logger.hpp"
+#include "thread/ThreadTaskExecutor.hpp"
+#include "util/BlockCompression.hpp"
+#include "util/Hash.hpp"
+#include "util/ImageLoader.hpp"
+#include "util/MipGenerator.hpp"
+
+#define TEXTURE_CACHE_DIRECTORY "cache/textures"
+#define TEXTURE_CACHE_MAGIC 0x58545654u
+#define TEXTURE_CACHE_VERSION 1u
+#define MAX_TEXTURE_WORKERS 8
+#define TEXTURE_TILE_BLOCK_ROWS 8
+
+struct ProcessedTexture
+{
+    TextureCompression compression = TextureCompression::NONE;
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    std::vector<std::vector<uint8_t>> levels = {};
+
+    bool Valid() const
+    {
+        return width > 0 && height > 0 && !levels.empty();
+    }
+};
+
+struct TextureCacheHeader
+{
+    uint32_t magic = TEXTURE_CACHE_MAGIC;
+    uint32_t version = TEXTURE_CACHE_VERSION;
+    uint32_t compression = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t levelCount = 0;
+};
+
+namespace TextureProcessor
+{
+    void RunParallel(size_t count, const std::function<void(size_t)>& function)
+    {
+        if (count == 0)
+            return;
+
+        size_t workerCount = std::min<size_t>(std::clamp<size_t>(std::thread::hardware_concurrency(), 1, MAX_TEXTURE_WORKERS), count);
+
+        if (workerCount == 1)
+        {
+            for (size_t i = 0; i < count; i++)
+                function(i);
+
+            return;
+        }
+
+        std::vector<std::unique_ptr<ThreadTaskExecutor>> workers;
+        std::latch finished((std::ptrdiff_t)count);
+
+        for (size_t i = 0; i < workerCount; i++)
+            workers.push_back(std::make_unique<ThreadTaskExecutor>());
+
+        for (size_t i = 0; i < count; i++)
+        {
+            workers[i % workerCount]->AddTask([i, &function, &finished]
+            {
+                function(i);
+                finished.count_down();
+            });
+        }
+
+        finished.wait();
+
+        for (auto& worker : workers)
+            worker->Terminate();
+    }
+
+    std::string GetCachePath(const std::vector<uint8_t>& source, TextureCompression compression, MipFilter filter)
+    {
+        uint64_t hash = Hash::Combine(Hash::FNV1a(source.data(), source.size()), source.size());
+
+        hash = Hash::Combine(hash, compression);
+        hash = Hash::Combine(hash, filter);
+        hash = Hash::Combine(hash, TEXTURE_CACHE_VERSION);
+
+        return std::format("{}/{:016x}.tex", TEXTURE_CACHE_DIRECTORY, hash);
+    }
+
+    bool ReadCache(const std::string& path, ProcessedTexture& texture)
+    {
+        std::vector<uint8_t> file;
+
+        if (!ImageLoader::ReadFile(path, file) || file.size() < sizeof(TextureCacheHeader))
+            return false;
+
+        TextureCacheHeader header = {};
+        memcpy(&header, file.data(), sizeof(header));
+
+        if (header.magic != TEXTURE_CACHE_MAGIC || header.version != TEXTURE_CACHE_VERSION || header.levelCount == 0)
+            return false;
+
+        texture.compression = (TextureCompression)header.compression;
+        texture.width = header.width;
+        texture.height = header.height;
+        texture.levels.clear();
+
+        size_t position = sizeof(header);
+
+        for (uint32_t level = 0; level < header.levelCount; level++)
+        {
+            size_t size = BlockCompression::GetLevelSize(texture.compression, std::max(header.width >> level, 1u), std::max(header.height >> level, 1u));
+
+            if (position + size > file.size())
+                return false;
+
+            texture.levels.emplace_back(file.begin() + position, file.begin() + position + size);
+            position += size;
+        }
+
+        return true;
+    }
+
+    void WriteCache(const std::string& path, const ProcessedTexture& texture)
+    {
+        std::filesystem::path temporaryPath = path + ".tmp";
+        std::error_code error;
+
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+        TextureCacheHeader header = {};
+
+        header.compression = (uint32_t)texture.compression;
+        header.width = texture.width;
+        header.height = texture.height;
+        header.levelCount = static_cast<uint32_t>(texture.levels.size());
+
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            for (const auto& level : texture.levels)
+                file.write(reinterpret_cast<const char*>(level.data()), level.size());
+
+            if (!file)
+            {
+                Logger_ThrowError("IO_FAILURE", "Failed to write texture cache to '" + temporaryPath.string() + "'", false);
+                std::filesystem::remove(temporaryPath, error);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path, error);
+    }
+
+    struct EncodeTile
+    {
+        size_t texture;
+        size_t level;
+        uint32_t firstRow;
+        uint32_t lastRow;
+    };
+
+    ProcessedTexture Prepare(const std::vector<ImageData>& mips, TextureCompression compression)
+    {
+        ProcessedTexture texture = { compression, mips[0].width, mips[0].height };
+
+        for (const auto& mip : mips)
+            texture.levels.emplace_back(BlockCompression::GetLevelSize(compression, mip.width, mip.height));
+
+        return texture;
+    }
+
+    void Encode(const std::vector<std::vector<ImageData>>& mips, std::vector<ProcessedTexture>& textures, const std::vector<size_t>& pending)
+    {
+        std::vector<EncodeTile> tiles;
+
+        for (size_t texture : pending)
+        {
+            for (size_t level = 0; level < mips[texture].size(); level++)
+            {
+                uint32_t rows = (mips[texture][level].height + 3) / 4;
+
+                for (uint32_t row = 0; row < rows; row += TEXTURE_TILE_BLOCK_ROWS)
+                    tiles.push_back({ texture, level, row, std::min(row + TEXTURE_TILE_BLOCK_ROWS, rows) });
+            }
+        }
+
+        RunParallel(tiles.size(), [&](size_t index)
+        {
+            const EncodeTile& tile = tiles[index];
+            const ImageData& image = mips[tile.texture][tile.level];
+            ProcessedTexture& texture = textures[tile.texture];
+
+            if (texture.compression == TextureCompression::NONE)
+            {
+                size_t rowSize = (size_t)image.width * 4;
+                size_t first = std::min<size_t>((size_t)tile.firstRow * 4, image.height);
+                size_t last = std::min<size_t>((size_t)tile.lastRow * 4, image.height);
+
+                memcpy(texture.levels[tile.level].data() + first * rowSize, image.pixels.data() + first * rowSize, (last - first) * rowSize);
+            }
+            else
+                BlockCompression::EncodeRows(image, texture.compression, tile.firstRow, tile.lastRow, texture.levels[tile.level].data());
+        });
+    }
+
+    ProcessedTexture ProcessImage(const ImageData& image, TextureCompression compression, MipFilter filter = MipFilter::KAISER)
+    {
+        std::vector<std::vector<ImageData>> mips = { MipGenerator::Generate(image, filter) };
+        std::vector<ProcessedTexture> textures = { Prepare(mips[0], compression) };
+
+        Encode(mips, textures, { 0 });
+
+        return textures[0];
+    }
+
+    std::vector<ProcessedTexture> ProcessFiles(const std::vector<std::string>& paths, TextureCompression compression, MipFilter filter = MipFilter::KAISER)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<ProcessedTexture> textures(paths.size());
+        std::vector<std::vector<ImageData>> mips(paths.size());
+        std::vector<std::string> cachePaths(paths.size());
+        std::atomic<size_t> cacheHits = 0;
+
+        RunParallel(paths.size(), [&](size_t index)
+        {
+            std::vector<uint8_t> file;
+            ImageData image = {};
+
+            if (!ImageLoader::ReadFile(paths[index], file))
+                return;
+
+            cachePaths[index] = GetCachePath(file, compression, filter);
+
+            if (ReadCache(cachePaths[index], textures[index]))
+            {
+                cacheHits++;
+                return;
+            }
+
+            textures[index] = {};
+
+            if (!ImageLoader::Load(file, std::filesystem::path(paths[index]).extension().string(), image))
+                return;
+
+            mips[index] = MipGenerator::Generate(image, filter);
+            textures[index] = Prepare(mips[index], compression);
+        });
+
+        std::vector<size_t> pending;
+
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            if (!mips[i].empty())
+                pending.push_back(i);
+        }
+
+        Encode(mips, textures, pending);
+
+        RunParallel(pending.size(), [&](size_t index)
+        {
+            WriteCache(cachePaths[pending[index]], textures[pending[index]]);
+        });
+
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        Logger_WriteConsole(std::format("Processed {} textures ({} from cache) in {:.1f} ms", paths.size(), cacheHits.load(), milliseconds), LogLevel::DEBUG);
+
+        return textures;
+    }
+}
+
+#endif // !TEXTURE_PROCESSOR_HPP
@@ -4,6 +4,8 @@
 #include <optional>
 #include <vector>
 #include <iostream>
+#include <cstring>
+#include <string>
 
 #define GLFW_INCLUDE_VULKAN
 #include <glad/glad.h>
@@ -123,11 +125,37 @@ namespace VulkanHelper
         return availableFormats[0];
     }
 
-    VkPresentModeKHR GetSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes) 
+    std::optional<VkPresentModeKHR> GetPresentModeByName(const std::string& name)
+    {
+        if (name == "immediate")
+            return VK_PRESENT_MODE_IMMEDIATE_KHR;
+        else if (name == "mailbox")
+            return VK_PRESENT_MODE_MAILBOX_KHR;
+        else if (name == "fifo")
+            return VK_PRESENT_MODE_FIFO_KHR;
+        else if (name == "fifo_relaxed")
+            return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+
+        return std::nullopt;
+    }
+
+    const char* GetPresentModeName(VkPresentModeKHR mode)
+    {
+        switch (mode)
+        {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR: return "immediate";
+        case VK_PRESENT_MODE_MAILBOX_KHR: return "mailbox";
+        case VK_PRESENT_MODE_FIFO_KHR: return "fifo";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "fifo_relaxed";
+        default: return "unknown";
+        }
+    }
+
+    VkPresentModeKHR GetSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes, VkPresentModeKHR preferred = VK_PRESENT_MODE_MAILBOX_KHR) 
     {
         for (const auto& availablePresentMode : availablePresentModes) 
         {
-            if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) 
+            if (availablePresentMode == preferred) 
                 return availablePresentMode;
         }
 
@@ -149,6 +177,68 @@ namespace VulkanHelper
         }
     }
 
+    VkFormat GetDepthFormat(VkPhysicalDevice device)
+    {
+        const VkFormat candidates[] = { VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT };
+
+        for (VkFormat format : candidates)
+        {
+            VkFormatProperties properties;
+            vkGetPhysicalDeviceFormatProperties(device, format, &properties);
+
+            if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT)
+                return format;
+        }
+
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    bool FindMemoryType(VkPhysicalDevice device, uint32_t typeFilter, VkMemoryPropertyFlags properties, uint32_t& index)
+    {
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(device, &memoryProperties);
+
+        for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+        {
+            if ((typeFilter & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+            {
+                index = i;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // vkEnumerateInstanceVersion only exists from 1.1 loaders on, a loader without it is 1.0
+    uint32_t GetInstanceVersion()
+    {
+        auto func = (PFN_vkEnumerateInstanceVersion)vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion");
+        uint32_t version = VK_API_VERSION_1_0;
+
+        if (func != nullptr && func(&version) != VK_SUCCESS)
+            version = VK_API_VERSION_1_0;
+
+        return version;
+    }
+
+    bool HasDeviceExtension(VkPhysicalDevice device, const char* name)
+    {
+        uint32_t extensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+        std::vector<VkExtensionProperties> extensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, extensions.data());
+
+        for (const auto& extension : extensions)
+        {
+            if (strcmp(extension.extensionName, name) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
     VkResult CreateDebugUtilsMessenger(VkInstance instance, const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDebugUtilsMessengerEXT* pDebugMessenger) 
     {
         auto func = (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(instance, "vkCreateDebugUtilsMessengerEXT");
@@ -0,0 +1,12 @@
+#!/bin/sh
+
+cd "$(dirname "$0")" || exit 1
+
+for file in *.vert *.frag; do
+    [ -e "$file" ] || continue
+
+    echo "Compiling $file"
+    glslangValidator -V "$file" -o "${file%.*}.spv"
+done
+
+echo "Compilation complete."